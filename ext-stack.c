@@ -0,0 +1,488 @@
+/**
+ * External-memory (disk-spilling) stack implementation in c
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-18: Initial creation
+ * 2026-10-19: Raise max_resident to EXTSTACK_MIN_RESIDENT (a single
+ *             resident segment thrashes at segment boundaries)
+ *
+ * USAGE: see ext-stack.h
+ */
+
+#ifndef _DEFAULT_SOURCE
+# define _DEFAULT_SOURCE // pread(), pwrite(), fileno(), posix_fadvise() in strict C modes
+#endif
+#include <stdlib.h>
+#include <string.h> // memcpy(), memmove()
+#include <fcntl.h>  // posix_fadvise()
+#include <unistd.h> // pread(), pwrite(), ftruncate()
+
+#define __EXTSTACK_EXTSTACK_C
+#include "ext-stack.h"
+#undef __EXTSTACK_EXTSTACK_C
+
+// Helper functions
+static inline size_t _ext_stack_segment_bytes(ext_stack_t *stack);
+static inline char *_ext_stack_slot(ext_stack_t *stack, char *segment, size_t index);
+static char *_ext_stack_take_buffer(ext_stack_t *stack);
+static void _ext_stack_put_buffer(ext_stack_t *stack, char *segment);
+static bool _ext_stack_spill(ext_stack_t *stack);
+static bool _ext_stack_fill(ext_stack_t *stack);
+static void _ext_stack_prefetch(ext_stack_t *stack);
+static bool _ext_stack_read(ext_stack_t *stack, void *buffer, size_t bytes, size_t offset);
+
+
+/**
+ * Heap-allocate a new external-memory stack. No segment is allocated
+ * until the first push, and no file is created until the first spill.
+ *
+ * @param **stack Pointer to the stack
+ * @param element_size [internal use] Size of element stored in stack
+ * @param segment_size Number of elements per segment (0 for as many
+ *                     as fit in EXTSTACK_DEFAULT_SEGMENT_BYTES)
+ * @param max_resident Maximum number of segments kept in memory
+ *                     (0 for EXTSTACK_DEFAULT_RESIDENT, values below
+ *                     EXTSTACK_MIN_RESIDENT are raised to it)
+ * @return false on success, true on failure (memory allocation failure)
+ */
+bool __ext_stack_init(ext_stack_t **stack, size_t element_size, size_t segment_size, size_t max_resident)
+{
+    if (!segment_size) {
+        segment_size = EXTSTACK_DEFAULT_SEGMENT_BYTES / element_size;
+        if (!segment_size) {
+            segment_size = 1;
+        }
+    }
+    if (!max_resident) {
+        max_resident = EXTSTACK_DEFAULT_RESIDENT;
+    }
+    else if (max_resident < EXTSTACK_MIN_RESIDENT) {
+        max_resident = EXTSTACK_MIN_RESIDENT;
+    }
+    if (segment_size > (size_t)-1 / element_size || max_resident > (size_t)-1 / sizeof(char *)) {
+        return true;
+    }
+
+    *stack = malloc(sizeof(**stack));
+    if (!*stack) {
+        return true;
+    }
+    (*stack)->resident = malloc(sizeof(char *) * max_resident);
+    if (!((*stack)->resident)) {
+        free(*stack);
+        *stack = NULL;
+        return true;
+    }
+    (*stack)->spare = NULL;
+    (*stack)->file = NULL;
+    (*stack)->number_of_resident = 0;
+    (*stack)->max_resident = max_resident;
+    (*stack)->number_of_spilled = 0;
+    (*stack)->top_count = 0;
+    (*stack)->segment_size = segment_size;
+    (*stack)->element_size = element_size;
+    (*stack)->number_of_items_in_table = 0;
+    return false;
+}
+
+
+/**
+ * Remove all elements from the stack, free its segments (except for one
+ * spare) and truncate its file. Does not free any contained data.
+ *
+ * @param *stack The stack to clear
+ */
+void __ext_stack_clear(ext_stack_t *stack)
+{
+    while (stack->number_of_resident) {
+        _ext_stack_put_buffer(stack, stack->resident[--(stack->number_of_resident)]);
+    }
+    if (stack->file) {
+        // Only gives the disk space back; the file is overwritten from the start either way
+        (void)ftruncate(fileno(stack->file), 0);
+    }
+    stack->number_of_spilled = 0;
+    stack->top_count = 0;
+    stack->number_of_items_in_table = 0;
+}
+
+
+/**
+ * Returns if there are any elements in the stack
+ *
+ * @param stack The stack to check if empty
+ * @return True if there are 0 elements in the stack,
+ *         False if not empty or if NULL stack
+ */
+bool __ext_stack_is_empty(ext_stack_t *stack)
+{
+    if (stack != NULL)
+    {
+        return (stack->number_of_items_in_table) == 0;
+    }
+    return 0;
+}
+
+
+/**
+ * Free an external-memory stack data structure and remove its file
+ * @note The *stack is set to NULL
+ *
+ * @param **stack The stack to free
+ */
+void __ext_stack_destroy(ext_stack_t **stack)
+{
+    if (!stack || !*stack) {
+        return;
+    }
+    while ((*stack)->number_of_resident) {
+        free((*stack)->resident[--((*stack)->number_of_resident)]);
+    }
+    if ((*stack)->file) {
+        fclose((*stack)->file);
+    }
+    free((*stack)->spare);
+    free((*stack)->resident);
+    free(*stack);
+    *stack = NULL;
+}
+
+
+/**
+ * Get the element on the top of the stack
+ *
+ * @param *stack The stack to look at
+ * @param *element A pointer to the location to store the peek'd value
+ * @return false on success, true on empty stack or null *element pointer
+ */
+bool __ext_stack_peek(ext_stack_t *stack, void *element)
+{
+    if (!element || __ext_stack_is_empty(stack)) {
+        return true;
+    }
+    memcpy(element,
+           _ext_stack_slot(stack, stack->resident[stack->number_of_resident - 1], stack->top_count - 1),
+           stack->element_size);
+    return false;
+}
+
+
+/**
+ * Get the element at an index relative to the top of the stack.
+ * Elements in spilled segments are read from the file.
+ *
+ * @param *stack The stack to look at
+ * @param *element A pointer to the location to store the peek'd value
+ * @param index The index, relative to the top of the stack, to retrieve.
+ *              If 0 is given, this behaves the same as __ext_stack_peek()
+ * @return false on success, true on empty stack or null *element pointer or
+ *         index outside of stack size or file read error
+ */
+bool __ext_stack_peeki(ext_stack_t *stack, void *element, size_t index)
+{
+    if (!element || __ext_stack_is_empty(stack) || index >= stack->number_of_items_in_table) {
+        return true;
+    }
+
+    // Index from the bottom of the stack, which does not depend on how
+    // many segments are in memory
+    size_t position = stack->number_of_items_in_table - 1 - index;
+    size_t segment = position / stack->segment_size;
+    size_t slot = position % stack->segment_size;
+
+    if (segment < stack->number_of_spilled) {
+        return _ext_stack_read(stack, element, stack->element_size,
+                               segment * _ext_stack_segment_bytes(stack) + slot * stack->element_size);
+    }
+    memcpy(element,
+           _ext_stack_slot(stack, stack->resident[segment - stack->number_of_spilled], slot),
+           stack->element_size);
+    return false;
+}
+
+
+/**
+ * Remove the top element on the stack and return its value
+ *
+ * @param *stack The stack to remove the element from
+ * @param *element A pointer to the location to store the pop'd value
+ * @return false on success, true on empty stack or null *element pointer
+ *         or file read error (nothing is pop'd)
+ */
+bool __ext_stack_pop(ext_stack_t *stack, void *element)
+{
+    if (__ext_stack_peek(stack, element)) {
+        return true;
+    }
+    return __ext_stack_drop(stack);
+}
+
+
+/**
+ * Remove the top element on the stack. Reads the next spilled segment
+ * back into memory if this empties the last resident segment.
+ *
+ * @param *stack The stack to remove the element from
+ * @return false on success, true on empty stack or on memory allocation
+ *         failure or file read error (nothing is removed)
+ */
+bool __ext_stack_drop(ext_stack_t *stack)
+{
+    if (__ext_stack_is_empty(stack)) {
+        return true;
+    }
+
+    if (stack->top_count == 1 && stack->number_of_resident == 1 && stack->number_of_spilled) {
+        // Read the segment below into place before letting go of the top
+        if (_ext_stack_fill(stack)) {
+            return true;
+        }
+        --(stack->number_of_items_in_table);
+        return false;
+    }
+
+    --(stack->number_of_items_in_table);
+    if (--(stack->top_count) == 0) {
+        _ext_stack_put_buffer(stack, stack->resident[--(stack->number_of_resident)]);
+        stack->top_count = stack->number_of_resident ? stack->segment_size : 0;
+        if (stack->number_of_resident == 1) {
+            _ext_stack_prefetch(stack);
+        }
+    }
+    return false;
+}
+
+
+/**
+ * Push an item onto the top of the stack. If a new segment is needed and
+ * the maximum number of segments are in memory, the bottom resident
+ * segment is written to the file first.
+ *
+ * @param *stack The stack to push the item onto
+ * @param *element The data to push onto the stack
+ * @return false on success, true on failure (memory allocation failure
+ *         or file write error)
+ */
+bool __ext_stack_push(ext_stack_t *stack, const void *element)
+{
+    if (!stack->number_of_resident || stack->top_count == stack->segment_size) {
+        if (stack->number_of_resident == stack->max_resident && _ext_stack_spill(stack)) {
+            return true;
+        }
+        char *segment = _ext_stack_take_buffer(stack);
+        if (!segment) {
+            return true;
+        }
+        stack->resident[(stack->number_of_resident)++] = segment;
+        stack->top_count = 0;
+    }
+
+    memcpy(_ext_stack_slot(stack, stack->resident[stack->number_of_resident - 1], stack->top_count),
+           element, stack->element_size);
+    ++(stack->top_count);
+    ++(stack->number_of_items_in_table);
+    return false;
+}
+
+
+/**
+ * Returns the number of items in the stack
+ *
+ * @param stack The stack to retrieve the number of elements from
+ * @return The number of elements in the stack (0 if stack is NULL)
+ */
+size_t __ext_stack_get_num_elements(ext_stack_t *stack)
+{
+    if (stack != NULL)
+    {
+        return (stack->number_of_items_in_table);
+    }
+    return 0;
+}
+
+
+/**
+ * Returns the number of items that are currently spilled to the file
+ *
+ * @param stack The stack to check
+ * @return The number of elements not in memory (0 if stack is NULL)
+ */
+size_t __ext_stack_get_num_spilled(ext_stack_t *stack)
+{
+    if (stack != NULL)
+    {
+        return stack->number_of_spilled * stack->segment_size;
+    }
+    return 0;
+}
+
+
+/**
+ * Get the size of a segment in bytes
+ *
+ * @param stack The stack
+ * @return The number of bytes in one segment
+ */
+static size_t _ext_stack_segment_bytes(ext_stack_t *stack)
+{
+    return stack->segment_size * stack->element_size;
+}
+
+
+/**
+ * Get the address of an element slot within a segment
+ *
+ * @param stack The stack
+ * @param segment The segment
+ * @param index The slot index within the segment
+ * @return A pointer to the slot
+ */
+static char *_ext_stack_slot(ext_stack_t *stack, char *segment, size_t index)
+{
+    return segment + (stack->element_size * index);
+}
+
+
+/**
+ * Get an empty segment buffer, reusing the spare one if there is one
+ *
+ * @param stack The stack
+ * @return The buffer, NULL on memory allocation failure
+ */
+static char *_ext_stack_take_buffer(ext_stack_t *stack)
+{
+    char *segment = stack->spare;
+    if (segment) {
+        stack->spare = NULL;
+        return segment;
+    }
+    return malloc(_ext_stack_segment_bytes(stack));
+}
+
+
+/**
+ * Give back a segment buffer that is no longer used, keeping it as the
+ * spare buffer if there is none
+ *
+ * @param stack The stack
+ * @param segment The buffer
+ */
+static void _ext_stack_put_buffer(ext_stack_t *stack, char *segment)
+{
+    if (stack->spare) {
+        free(segment);
+    }
+    else {
+        stack->spare = segment;
+    }
+}
+
+
+/**
+ * Write the bottom resident segment (which is full) to the end of the
+ * spilled segments in the file and free up its buffer
+ *
+ * @param stack The stack
+ * @return false on success, true on failure (file creation or write error)
+ */
+static bool _ext_stack_spill(ext_stack_t *stack)
+{
+    if (!stack->file) {
+        stack->file = tmpfile();
+        if (!stack->file) {
+            return true;
+        }
+    }
+
+    size_t bytes = _ext_stack_segment_bytes(stack);
+    off_t offset = (off_t)(stack->number_of_spilled * bytes);
+    const char *segment = stack->resident[0];
+    int fd = fileno(stack->file);
+
+    for (size_t done = 0; done < bytes; ) {
+        ssize_t n = pwrite(fd, segment + done, bytes - done, offset + (off_t)done);
+        if (n <= 0) {
+            return true;
+        }
+        done += (size_t)n;
+    }
+
+    _ext_stack_put_buffer(stack, stack->resident[0]);
+    memmove(stack->resident, stack->resident + 1, sizeof(char *) * (stack->number_of_resident - 1));
+    --(stack->number_of_resident);
+    ++(stack->number_of_spilled);
+    return false;
+}
+
+
+/**
+ * Replace the only resident segment (which is about to be emptied) with
+ * the last spilled segment read back from the file
+ *
+ * @param stack The stack
+ * @return false on success, true on failure (memory allocation failure
+ *         or file read error)
+ */
+static bool _ext_stack_fill(ext_stack_t *stack)
+{
+    char *segment = _ext_stack_take_buffer(stack);
+    if (!segment) {
+        return true;
+    }
+    size_t bytes = _ext_stack_segment_bytes(stack);
+    if (_ext_stack_read(stack, segment, bytes, (stack->number_of_spilled - 1) * bytes)) {
+        _ext_stack_put_buffer(stack, segment);
+        return true;
+    }
+
+    _ext_stack_put_buffer(stack, stack->resident[0]);
+    stack->resident[0] = segment;
+    stack->top_count = stack->segment_size;
+    --(stack->number_of_spilled);
+    _ext_stack_prefetch(stack);
+    return false;
+}
+
+
+/**
+ * Ask the kernel to start reading the last spilled segment, since it
+ * will be needed once the only resident segment is empty
+ *
+ * @param stack The stack
+ */
+static void _ext_stack_prefetch(ext_stack_t *stack)
+{
+#ifdef POSIX_FADV_WILLNEED
+    if (stack->number_of_spilled) {
+        size_t bytes = _ext_stack_segment_bytes(stack);
+        (void)posix_fadvise(fileno(stack->file), (off_t)((stack->number_of_spilled - 1) * bytes),
+                            (off_t)bytes, POSIX_FADV_WILLNEED);
+    }
+#else
+    (void)stack;
+#endif
+}
+
+
+/**
+ * Read bytes from the stack's file
+ *
+ * @param stack The stack
+ * @param buffer The location to read into
+ * @param bytes The number of bytes to read
+ * @param offset The offset in the file to read from
+ * @return false on success, true on failure (file read error)
+ */
+static bool _ext_stack_read(ext_stack_t *stack, void *buffer, size_t bytes, size_t offset)
+{
+    int fd = fileno(stack->file);
+    for (size_t done = 0; done < bytes; ) {
+        ssize_t n = pread(fd, (char *)buffer + done, bytes - done, (off_t)(offset + done));
+        if (n <= 0) {
+            return true;
+        }
+        done += (size_t)n;
+    }
+    return false;
+}
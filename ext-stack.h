@@ -0,0 +1,159 @@
+/**
+ * External-memory (disk-spilling) stack implementation in c
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-18: Initial creation
+ * 2026-10-19: Keep at least EXTSTACK_MIN_RESIDENT segments in memory
+ *
+ * USAGE:
+ * Define EXTSTACK_DATA_T as the data type to be stored in the stack structure.
+ * Define EXTSTACK_DATA_NAME as the data name for the associated function calls.
+ * **NOTE**: Do not enclose the above macros in parens! For example, if the
+ *           data type is char* , define the macros as char* , not (char*)
+ * **NOTE**: Elements are stored by value and are written to disk as raw
+ *           bytes, so pointers stored in the stack are only meaningful to
+ *           the process that pushed them.
+ *
+ * Like the Segmented Stack, the stack is made of fixed-size segments. Only
+ * the top max_resident segments are kept in memory. When a push needs a new
+ * segment and max_resident segments are already in memory, the bottom
+ * resident segment is written to a temporary file (one write of a whole
+ * segment) and its buffer is reused for the new top segment. Memory use is
+ * therefore bounded by max_resident segments no matter how deep the stack
+ * gets.
+ *
+ * Once pops reach the last resident segment, the kernel is told to start
+ * reading the next spilled segment in the background (where supported), and
+ * it is read back in when the resident segment empties. Since a spilled
+ * segment is only read back once all resident segments are gone, pushing
+ * and popping around the boundary does not cause repeated writes and reads.
+ * This needs room for two segments in memory (the one being emptied and
+ * the one being filled), so max_resident is at least EXTSTACK_MIN_RESIDENT
+ * (smaller values are raised to it). With a single resident segment, every
+ * push/pop pair across a segment boundary would write and read back a
+ * whole segment.
+ *
+ * The temporary file is created by tmpfile() on the first spill and is
+ * removed when the stack is destroyed (or the process exits).
+ * **NOTE**: Requires POSIX (pread(), pwrite()).
+ */
+
+#include <stddef.h> // size_t
+#include <stdbool.h>
+#include <stdio.h>  // FILE
+
+#ifndef EXTSTACK_H
+#define EXTSTACK_H
+
+#define EXTSTACK_DEFAULT_SEGMENT_BYTES (1 << 20)
+#define EXTSTACK_DEFAULT_RESIDENT 4
+#define EXTSTACK_MIN_RESIDENT 2
+
+#define _EXTSTACK_GLUE(x, y) x##y
+#define EXTSTACK_GLUE(x, y) _EXTSTACK_GLUE(x, y)
+
+typedef struct ext_stack_t {
+    char **resident;                       // In-memory segments, bottom first (the last one is the top)
+    char *spare;                           // Empty segment buffer kept for reuse (NULL if none)
+    FILE *file;                            // Spilled segments (NULL until the first spill)
+    size_t number_of_resident;             // Number of segments in memory
+    size_t max_resident;                   // Maximum number of segments in memory
+    size_t number_of_spilled;              // Number of segments in the file
+    size_t top_count;                      // Number of items in the top segment
+    size_t segment_size;                   // Number of items per segment
+    size_t element_size;                   // Size of an item in bytes
+    size_t number_of_items_in_table;       // Number of items in the stack
+} ext_stack_t;
+
+bool __ext_stack_init(ext_stack_t **stack, size_t element_size, size_t segment_size, size_t max_resident);
+void __ext_stack_clear(ext_stack_t *stack);
+bool __ext_stack_is_empty(ext_stack_t *stack);
+void __ext_stack_destroy(ext_stack_t **stack);
+bool __ext_stack_peek(ext_stack_t *stack, void *element);
+bool __ext_stack_peeki(ext_stack_t *stack, void *element, size_t index);
+bool __ext_stack_pop(ext_stack_t *stack, void *element);
+bool __ext_stack_drop(ext_stack_t *stack);
+bool __ext_stack_push(ext_stack_t *stack, const void *element);
+size_t __ext_stack_get_num_elements(ext_stack_t *stack);
+size_t __ext_stack_get_num_spilled(ext_stack_t *stack);
+
+#endif
+
+// Now on to the "type generic weirdness"
+#ifndef __EXTSTACK_EXTSTACK_C
+
+#if !defined(EXTSTACK_DATA_NAME) || !defined(EXTSTACK_DATA_T)
+# error "Must define both EXTSTACK_DATA_NAME and EXTSTACK_DATA_T before including ext-stack.h"
+#endif
+
+#define __EXTSTACK_T EXTSTACK_GLUE(EXTSTACK_DATA_NAME, _ext_stack_t)
+
+// Wrapping the untyped stack gives each generic type its own struct so
+// that mixing stacks of different types is caught at compile time
+typedef struct __EXTSTACK_T {
+    ext_stack_t stack;
+} __EXTSTACK_T;
+
+// Function prototypes
+static inline bool EXTSTACK_GLUE(EXTSTACK_DATA_NAME, _ext_stack_init)(__EXTSTACK_T **stack, size_t segment_size, size_t max_resident)
+{
+    return __ext_stack_init((ext_stack_t**)stack, sizeof(EXTSTACK_DATA_T), segment_size, max_resident);
+}
+
+static inline void EXTSTACK_GLUE(EXTSTACK_DATA_NAME, _ext_stack_clear)(__EXTSTACK_T *stack)
+{
+    __ext_stack_clear((ext_stack_t*)stack);
+}
+
+static inline bool EXTSTACK_GLUE(EXTSTACK_DATA_NAME, _ext_stack_is_empty)(__EXTSTACK_T *stack)
+{
+    return __ext_stack_is_empty((ext_stack_t*)stack);
+}
+
+static inline void EXTSTACK_GLUE(EXTSTACK_DATA_NAME, _ext_stack_destroy)(__EXTSTACK_T **stack)
+{
+    __ext_stack_destroy((ext_stack_t**)stack);
+}
+
+static inline bool EXTSTACK_GLUE(EXTSTACK_DATA_NAME, _ext_stack_peek)(__EXTSTACK_T *stack, EXTSTACK_DATA_T *element)
+{
+    return __ext_stack_peek((ext_stack_t*)stack, (void *)element);
+}
+
+static inline bool EXTSTACK_GLUE(EXTSTACK_DATA_NAME, _ext_stack_peeki)(__EXTSTACK_T *stack, EXTSTACK_DATA_T *element, size_t index)
+{
+    return __ext_stack_peeki((ext_stack_t*)stack, (void *)element, index);
+}
+
+static inline bool EXTSTACK_GLUE(EXTSTACK_DATA_NAME, _ext_stack_pop)(__EXTSTACK_T *stack, EXTSTACK_DATA_T *element)
+{
+    return __ext_stack_pop((ext_stack_t*)stack, (void *)element);
+}
+
+static inline bool EXTSTACK_GLUE(EXTSTACK_DATA_NAME, _ext_stack_drop)(__EXTSTACK_T *stack)
+{
+    return __ext_stack_drop((ext_stack_t*)stack);
+}
+
+static inline bool EXTSTACK_GLUE(EXTSTACK_DATA_NAME, _ext_stack_push)(__EXTSTACK_T *stack, EXTSTACK_DATA_T element)
+{
+    return __ext_stack_push((ext_stack_t*)stack, (const void *)&element);
+}
+
+static inline size_t EXTSTACK_GLUE(EXTSTACK_DATA_NAME, _ext_stack_get_num_elements)(__EXTSTACK_T *stack)
+{
+    return __ext_stack_get_num_elements((ext_stack_t*)stack);
+}
+
+static inline size_t EXTSTACK_GLUE(EXTSTACK_DATA_NAME, _ext_stack_get_num_spilled)(__EXTSTACK_T *stack)
+{
+    return __ext_stack_get_num_spilled((ext_stack_t*)stack);
+}
+
+#undef EXTSTACK_DATA_T
+#undef EXTSTACK_DATA_NAME
+#undef __EXTSTACK_T
+
+#endif
+
@@ -15,18 +15,41 @@
  *             table resize (added __ht_put_nia())
  * 2023-07-02: Use ht_index_t in init() and clear() instead
  *             of int for iteration index
+ * 2026-10-18: Add __ht_get_entry()
+ * 2026-10-18: Add __ht_retain() for single-pass bulk removal
+ *             (table resizes now share _ht_resize_table())
+ * 2026-10-18: Add length-delimited (pointer, length) string key
+ *             variants of the string key functions
+ * 2026-10-18: Add batch string hashing and batch lookup
+ * 2026-10-18: Add copy-on-write snapshots. clear() now frees
+ *             every entry in the collision lists and resets the
+ *             element counts.
+ * 2026-10-19: Hash batches of strings with the plain serial loop
+ *             (the blocked and AVX2/AVX-512 versions were slower)
  */
 
+#include <limits.h> // CHAR_BIT
+
 #define __HT_HT_C
 #include "hashtable.h"
 #undef __HT_HT_C
 
+#define HT_SHARED_WORD_BITS (sizeof(unsigned long) * CHAR_BIT)
+
 // Helper functions
 static inline ht_index_t _ht_compute_index(ht_t *table, ht_key_t key);
 // static inline float _ht_get_collision_average(ht_t *table);
 static inline float _ht_get_load_factor(ht_t *table);
 static void _ht_double_table(ht_t *table);
 static void _ht_half_table(ht_t *table);
+static void _ht_resize_table(ht_t *table, ht_index_t newSize);
+static inline bool _ht_is_snapshot(ht_t *table);
+static inline bool _ht_bucket_is_shared(ht_t *table, ht_index_t index);
+static bool _ht_cow_prepare(ht_t *table);
+static bool _ht_cow_bucket(ht_t *table, ht_index_t index);
+static bool _ht_unshare_all(ht_t *table);
+static void _ht_detach_snapshot(ht_t *table);
+static void _ht_free_chain(ht_entry_t *node);
 
 
 /**
@@ -48,6 +71,8 @@ bool __ht_init(ht_t **table)
     (*table)->currentLoadFactor = 0;
     (*table)->numberOfItemsInTable = 0;
     (*table)->numberOfSlotsUsed = 0;
+    (*table)->snapshot = NULL;
+    (*table)->sharedBuckets = NULL;
     (*table)->table = malloc(sizeof(*((*table)->table)) * (*table)->arraySize);
 
     if ((*table)->table == NULL) {
@@ -64,26 +89,48 @@ bool __ht_init(ht_t **table)
 /**
  * Reset the hashtable to its original size and remove the elements from it<br>
  * Note: <code>free()</code>s all elements in table array!
+ * Note: Buckets still shared with a snapshot are left to the snapshot
  * 
  * @param table The hashtable to be cleared
  */
 void __ht_clear(ht_t *table)
 {
-    if (table != NULL)
+    if (table != NULL && !_ht_is_snapshot(table))
     {
-        // Free the elements in the table
-        for (ht_index_t i = 0; i < table->arraySize; i++)
+        ht_entry_t **newTable = malloc(sizeof(*(table->table)) * HT_INITIAL_SIZE);
+        if (newTable == NULL)
         {
-            if (table->table[i])
+            return;
+        }
+
+        // Free the elements in the table. If the array itself has not been
+        // copied since the snapshot was taken, everything belongs to the snapshot.
+        if (table->snapshot == NULL || table->sharedBuckets != NULL)
+        {
+            for (ht_index_t i = 0; i < table->arraySize; i++)
             {
-                free(table->table[i]);
+                if (!_ht_bucket_is_shared(table, i))
+                {
+                    _ht_free_chain(table->table[i]);
+                }
             }
+            free(table->table);
+        }
+        if (table->snapshot != NULL)
+        {
+            _ht_detach_snapshot(table);
         }
-        free(table->table);
 
         // Create new table
         table->arraySize = HT_INITIAL_SIZE;
-        table->table = malloc(sizeof(*(table->table)) * table->arraySize);
+        table->table = newTable;
+        table->currentLoadFactor = 0;
+        table->numberOfItemsInTable = 0;
+        table->numberOfSlotsUsed = 0;
+        for (ht_index_t i = 0; i < table->arraySize; i++)
+        {
+            table->table[i] = NULL;
+        }
     }
 }
 
@@ -106,7 +153,7 @@ void __ht_clear(ht_t *table)
  */
 bool __ht_put_nia(ht_t *table, ht_key_t key, void *value, ht_entry_t *item)
 {
-    if (table == NULL) {
+    if (table == NULL || _ht_is_snapshot(table)) {
         if (item) {
             free(item);
         }
@@ -114,6 +161,12 @@ bool __ht_put_nia(ht_t *table, ht_key_t key, void *value, ht_entry_t *item)
     }
 
     ht_index_t pointer = _ht_compute_index(table, key);
+
+    // Don't modify a collision list that a snapshot can still see
+    if (table->snapshot != NULL && _ht_cow_bucket(table, pointer)) {
+        free(item);
+        return true;
+    }
             
     item->next = NULL;
     item->value = value;
@@ -218,6 +271,29 @@ bool __ht_sput(ht_t *table, char *key, void *value)
 }
 
 
+/**
+ * Add an element to the hashtable using a length-delimited string key.
+ * The key does not need to be NUL-terminated and hashes the same as
+ * the equivalent NUL-terminated key given to __ht_sput()
+ * Assumes that you have already malloc()'d the value pointer
+ * 
+ * @param table The HashTable to be operated upon
+ * @param key The first character of the key
+ * @param len The number of characters in the key
+ * @param value The value to be associated with the key
+ * @return true on failure, false on success
+ */
+bool __ht_snput(ht_t *table, const char *key, size_t len, void *value)
+{
+    if (table != NULL && key != NULL)
+    {
+        ht_key_t keyi = __ht_hash_nstring(key, len);
+        return __ht_put(table, keyi, value);
+    }
+    return true;
+}
+
+
 /**
  * Get an element from the hashtable based on the specified key
  * 
@@ -227,6 +303,31 @@ bool __ht_sput(ht_t *table, char *key, void *value)
  *         (NULL if table is NULL or it element does not exist)
  */
 void *__ht_get(ht_t *table, ht_key_t key)
+{
+    ht_entry_t *node = __ht_get_entry(table, key);
+    if (node != NULL)
+    {
+        return node->value;
+    }
+    return NULL;
+}
+
+
+/**
+ * Get the entry node that holds the specified key
+ *
+ * @note The entry is owned by the table. It is only valid until 
+ *       the key is removed or the table is destroyed. Entries are
+ *       not reallocated when the table resizes, so containers that
+ *       allocate larger entries for __ht_put_nia() may cast the
+ *       returned pointer back to their own entry type.
+ * 
+ * @param table The table in which to search for the key
+ * @param key The key to search for
+ * @return The entry holding the key
+ *         (NULL if table is NULL or it element does not exist)
+ */
+ht_entry_t *__ht_get_entry(ht_t *table, ht_key_t key)
 {
     if (table != NULL)
     {
@@ -238,7 +339,7 @@ void *__ht_get(ht_t *table, ht_key_t key)
         {
             if (node->key == key)
             {
-                return node->value;
+                return node;
             }
             node = node->next;
         }
@@ -267,16 +368,37 @@ void *__ht_sget(ht_t *table, char *key)
 }
 
 
+/**
+ * Get an element from the hashtable based on a length-delimited string key
+ * 
+ * @param table The table in which to search for the key
+ * @param key The first character of the key
+ * @param len The number of characters in the key
+ * @return The value corresponding to the key specified 
+ *         (NULL if table is NULL or it element does not exist)
+ */
+void *__ht_snget(ht_t *table, const char *key, size_t len)
+{
+    if (table != NULL && key != NULL)
+    {
+        ht_key_t keyi = __ht_hash_nstring(key, len);
+        return __ht_get(table, keyi);
+    }
+    return NULL;
+}
+
+
 /**
  * Remove an item from the table
  * 
  * @param table The table from which to remove an element
  * @param key The key for the value to be removed
  * @return The value associated with the key, NULL if no such element exists
+ *         (or if table is a snapshot)
  */
 void *__ht_remove(ht_t *table, ht_key_t key)
 {
-    if (table != NULL)
+    if (table != NULL && !_ht_is_snapshot(table))
     {
         // Calculate location in the table
         ht_index_t hashValue = _ht_compute_index(table, key);
@@ -288,6 +410,15 @@ void *__ht_remove(ht_t *table, ht_key_t key)
         {
             if (node->key == key)
             {
+                // The list is still shared with a snapshot: copy it and remove from the copy
+                if (_ht_bucket_is_shared(table, hashValue))
+                {
+                    if (_ht_cow_bucket(table, hashValue))
+                    {
+                        return NULL;
+                    }
+                    return __ht_remove(table, key);
+                }
                 if (previousNode == NULL)
                 {
                     table->table[hashValue] = node->next;
@@ -344,6 +475,25 @@ void *__ht_sremove(ht_t *table, char *key)
 }
 
 
+/**
+ * Remove an item from the table based on a length-delimited string key
+ * 
+ * @param table The table from which to remove an element
+ * @param key The first character of the key
+ * @param len The number of characters in the key
+ * @return The value associated with the key, NULL if no such element exists
+ */
+void *__ht_snremove(ht_t *table, const char *key, size_t len)
+{
+    if (table != NULL && key != NULL)
+    {
+        ht_key_t keyi = __ht_hash_nstring(key, len);
+        return __ht_remove(table, keyi);
+    }
+    return NULL; // Not Found
+}
+
+
 /**
  * Search if a key exists
  * 
@@ -403,6 +553,123 @@ bool __ht_contains_skey(ht_t *table, char *key)
 }
 
 
+/**
+ * Search if a length-delimited string key exists
+ * 
+ * @param table The table in which to check for the key
+ * @param key The first character of the key
+ * @param len The number of characters in the key
+ * @return true if the key is found, 
+ *         false if not found or if table is NULL
+ */
+bool __ht_contains_snkey(ht_t *table, const char *key, size_t len)
+{
+    if (table != NULL && key != NULL)
+    {
+        return __ht_contains_key(table, __ht_hash_nstring(key, len));
+    }
+    return false;
+}
+
+
+/**
+ * Remove every element for which keep() returns false in a single
+ * pass over the table. The table is resized at most once, after all
+ * of the rejected elements have been removed.
+ * @note This does NOT free() the removed values. They are handed to
+ *       removed() (if not NULL) for the caller to dispose of.
+ * @note Neither callback may modify the table
+ * 
+ * @param table The table to filter
+ * @param keep Returns true for the elements that should stay in the table
+ * @param removed Called with every element removed from the table (may be NULL)
+ * @param ctx User pointer passed through to keep() and removed()
+ * @return The number of elements removed (0 if table or keep is NULL
+ *         or if table is a snapshot)
+ */
+ht_index_t __ht_retain(ht_t *table, ht_retain_fn keep, ht_value_fn removed, void *ctx)
+{
+    ht_index_t removedCount = 0;
+    if (table == NULL || keep == NULL || _ht_is_snapshot(table))
+    {
+        return 0;
+    }
+
+    for (ht_index_t i = 0; i < table->arraySize; i++)
+    {
+        ht_entry_t **link = &(table->table[i]);
+        if (*link == NULL)
+        {
+            continue;
+        }
+
+        ht_index_t position = 0;
+        while (*link != NULL)
+        {
+            ht_entry_t *node = *link;
+            if (keep(node->key, node->value, ctx))
+            {
+                link = &(node->next);
+                position++;
+                continue;
+            }
+
+            // Copy a list shared with a snapshot before unlinking from it,
+            // then find the copy of the rejected node
+            if (_ht_bucket_is_shared(table, i))
+            {
+                if (_ht_cow_bucket(table, i))
+                {
+                    break; // Keep the rest of this list
+                }
+                link = &(table->table[i]);
+                for (ht_index_t p = 0; p < position; p++)
+                {
+                    link = &((*link)->next);
+                }
+                node = *link;
+            }
+
+            *link = node->next;
+            ht_key_t key = node->key;
+            void *value = node->value;
+            free(node);
+            removedCount++;
+            if (removed)
+            {
+                removed(key, value, ctx);
+            }
+        }
+
+        if (table->table[i] == NULL)
+        {
+            table->numberOfSlotsUsed--;
+        }
+    }
+
+    if (removedCount == 0)
+    {
+        return 0;
+    }
+
+    table->numberOfItemsInTable -= removedCount;
+    table->currentLoadFactor = _ht_get_load_factor(table);
+
+    // Pick the final size up front so that the purge costs at most one rehash
+    ht_index_t newSize = table->arraySize;
+    while (newSize >= 2 * HT_INITIAL_SIZE &&
+           ((float)table->numberOfItemsInTable) / ((float)newSize) + HT_DEFAULT_MAX_NGATIVE_LOAD_FACTOR_VARIANCE < HT_DEFAULT_LOAD_FACTOR)
+    {
+        newSize /= 2;
+    }
+    if (newSize != table->arraySize)
+    {
+        _ht_resize_table(table, newSize);
+    }
+    return removedCount;
+}
+
+
 /**
  * Free a HashTable. 
  * @note This does NOT free() the values stored
@@ -414,28 +681,130 @@ void __ht_destroy(ht_t **table)
 {
     if (table != NULL && *table != NULL)
     {
-        ht_entry_t *node, *node2;
-        for (ht_index_t i = 0; i < (*table)->arraySize; i++)
+        if (_ht_is_snapshot(*table))
+        {
+            __ht_snapshot_release(table);
+            return;
+        }
+
+        // Anything still shared with a snapshot is handed over to it
+        if ((*table)->snapshot == NULL || (*table)->sharedBuckets != NULL)
         {
-            if ((*table)->table[i] != NULL)
+            for (ht_index_t i = 0; i < (*table)->arraySize; i++)
             {
-                // If needed, free the collision list
-                node = (*table)->table[i];
-                while (node != NULL)
+                if (!_ht_bucket_is_shared(*table, i))
                 {
-                    node2 = node->next;
-                    free(node);
-                    node = node2;
+                    _ht_free_chain((*table)->table[i]);
                 }
             }
+            free((*table)->table);
+        }
+        if ((*table)->snapshot != NULL)
+        {
+            _ht_detach_snapshot(*table);
         }
-        free((*table)->table);
         free(*table);
         *table = NULL;
     }
 }
 
 
+/**
+ * Take a read-only snapshot of the table in O(1). The snapshot shares
+ * the table's buckets; the table copies a bucket before it first modifies
+ * it. Use the snapshot with the lookup and iterator functions only.
+ * @note If the table already has a snapshot and has not been modified
+ *       since it was taken, the same snapshot is returned again (release
+ *       it once per call). Otherwise the old snapshot is detached first,
+ *       which copies the buckets that it still shares with the table.
+ * @note Must not run concurrently with writes to the table
+ * 
+ * @param table The table to take a snapshot of
+ * @return The snapshot, NULL if table is NULL or a snapshot itself,
+ *         or if memory allocation fails
+ */
+ht_t *__ht_snapshot(ht_t *table)
+{
+    if (table == NULL || _ht_is_snapshot(table))
+    {
+        return NULL;
+    }
+
+    if (table->snapshot != NULL)
+    {
+        if (table->sharedBuckets == NULL)
+        {
+            table->snapshot->refs++;
+            return &(table->snapshot->view);
+        }
+        if (_ht_unshare_all(table))
+        {
+            return NULL;
+        }
+    }
+
+    ht_snapshot_t *snapshot = malloc(sizeof(*snapshot));
+    if (snapshot == NULL)
+    {
+        return NULL;
+    }
+
+    snapshot->view = *table;
+    snapshot->view.snapshot = snapshot; // Marks the view as read-only
+    snapshot->owner = table;
+    snapshot->refs = 1;
+    table->snapshot = snapshot;
+    return &(snapshot->view);
+}
+
+
+/**
+ * Release a snapshot taken with __ht_snapshot(). Frees the buckets that
+ * only the snapshot still references.
+ * @note Must not run concurrently with writes to the table the
+ *       snapshot was taken from
+ * @note The *snapshot is set to NULL
+ * 
+ * @param snapshot The snapshot to release
+ */
+void __ht_snapshot_release(ht_t **snapshot)
+{
+    if (snapshot == NULL || *snapshot == NULL || !_ht_is_snapshot(*snapshot))
+    {
+        return;
+    }
+
+    ht_snapshot_t *snap = (*snapshot)->snapshot;
+    *snapshot = NULL;
+    if (--(snap->refs) > 0)
+    {
+        return;
+    }
+
+    ht_t *owner = snap->owner;
+    if (owner == NULL || owner->sharedBuckets != NULL)
+    {
+        for (ht_index_t i = 0; i < snap->view.arraySize; i++)
+        {
+            // Buckets the owner has not copied are still in use by the owner
+            if (owner == NULL || !_ht_bucket_is_shared(owner, i))
+            {
+                _ht_free_chain(snap->view.table[i]);
+            }
+        }
+        free(snap->view.table);
+    }
+    if (owner != NULL)
+    {
+        // The owner now has the only reference to its buckets
+        free(owner->sharedBuckets);
+        owner->sharedBuckets = NULL;
+        owner->snapshot = NULL;
+    }
+    free(snap);
+}
+
+
 /**
  * Returns if the hashtable contains 0 elements
  *
@@ -494,6 +863,94 @@ ht_key_t __ht_hash_string(const char *string)
 }
 
 
+/**
+ * Computes a hash value of a length-delimited string. Produces the
+ * same value as __ht_hash_string() for the same characters, so the
+ * two kinds of string keys can be mixed on one table.
+ * 
+ * @param string The first character of the string to be hashed
+ * @param len The number of characters to hash
+ * @return The hashvalue of the string, 0 if string is NULL
+ */
+ht_key_t __ht_hash_nstring(const char *string, size_t len)
+{
+    if (string != NULL)
+    {
+        // Same algorithm as __ht_hash_string()
+        ht_key_t hash = 0;
+        for (size_t i = 0; i < len; i++)
+        {
+            int c = string[i];
+            hash += c + (hash << 6) + (hash << 16) - hash;
+        }
+        return hash;
+    }
+    return 0;
+}
+
+
+/**
+ * Computes the hash values of a batch of length-delimited strings.
+ * Produces the same values as calling __ht_hash_nstring() on each string.
+ * 
+ * @param strings The first character of each string (NULL entries hash to 0)
+ * @param lens The number of characters in each string
+ * @param hashes Where to store the n hash values
+ * @param n The number of strings
+ */
+void __ht_hash_nstrings(const char *const *strings, const size_t *lens, ht_key_t *hashes, size_t n)
+{
+    if (strings == NULL || lens == NULL || hashes == NULL)
+    {
+        return;
+    }
+    for (size_t i = 0; i < n; i++)
+    {
+        hashes[i] = __ht_hash_nstring(strings[i], lens[i]);
+    }
+}
+
+
+/**
+ * Look up a batch of length-delimited string keys. The keys are hashed
+ * with __ht_hash_nstrings() and the buckets of a block of keys are
+ * prefetched before any of them are walked.
+ * 
+ * @param table The table in which to search for the keys
+ * @param keys The first character of each key
+ * @param lens The number of characters in each key
+ * @param values Where to store the n values (NULL for keys not found)
+ * @param n The number of keys
+ * @return The number of keys found
+ */
+size_t __ht_snget_batch(ht_t *table, const char *const *keys, const size_t *lens, void **values, size_t n)
+{
+    size_t found = 0;
+    if (table == NULL || keys == NULL || lens == NULL || values == NULL)
+    {
+        return 0;
+    }
+
+    ht_key_t hashes[HT_HASH_BATCH_LANES];
+    for (size_t i = 0; i < n; i += HT_HASH_BATCH_LANES)
+    {
+        size_t lanes = (n - i < HT_HASH_BATCH_LANES) ? n - i : HT_HASH_BATCH_LANES;
+        __ht_hash_nstrings(keys + i, lens + i, hashes, lanes);
+
+        for (size_t l = 0; l < lanes; l++)
+        {
+            __builtin_prefetch(&(table->table[_ht_compute_index(table, hashes[l])]));
+        }
+        for (size_t l = 0; l < lanes; l++)
+        {
+            values[i + l] = (keys[i + l] != NULL) ? __ht_get(table, hashes[l]) : NULL;
+            found += (values[i + l] != NULL);
+        }
+    }
+    return found;
+}
+
+
 /**
  * Computes the pointer offset of a specified key into 
  * the hash table internal array
@@ -555,72 +1012,230 @@ static void _ht_double_table(ht_t *table)
 {
     if (table != NULL)
     {
-        // Keep a reference to the old table in the iterator
-        ht_itr_t *itr = __ht_create_iterator(table);
-        table->arraySize = table->arraySize * 2;
-        table->table = malloc(sizeof(ht_entry_t *) * table->arraySize);
+        _ht_resize_table(table, table->arraySize * 2);
+    }
+}
 
-        // Reset the values
-        table->currentLoadFactor = 0;
-        table->numberOfItemsInTable = 0;
-        table->numberOfSlotsUsed = 0;
 
-        for (ht_index_t i = 0; i < table->arraySize; i++)
-        {
-            table->table[i] = NULL;
-        }
+/**
+ * Halve the size of the array for holding elements in the specified HashTable
+ * 
+ * @param table The table to be halved
+ */
+static void _ht_half_table(ht_t *table)
+{
+    if (table != NULL && (table->arraySize) >= (2 * HT_INITIAL_SIZE))
+    {
+        _ht_resize_table(table, (table->arraySize) / 2);
+    }
+}
 
-        // Loop throught the original table and rehash them into the new table
-        while (__ht_iterator_has_next(itr))
-        {
-            ht_entry_t *node = __ht_iterator_next(itr);
-            __ht_put_nia(table, node->key, node->value, node);
-        }
 
-        // Free the old table
-        free(itr->iteratorTable);
+/**
+ * Rehash every element of the specified HashTable into a new array
+ * @note If the new array cannot be allocated, the table is left as-is
+ * 
+ * @param table The table to be resized
+ * @param newSize The number of slots in the new array
+ */
+static void _ht_resize_table(ht_t *table, ht_index_t newSize)
+{
+    // Rehashing relinks every entry, so give up sharing with the snapshot first
+    if (table->snapshot != NULL && _ht_unshare_all(table))
+    {
+        return;
+    }
+
+    ht_entry_t **newTable = malloc(sizeof(ht_entry_t *) * newSize);
+    if (newTable == NULL)
+    {
+        return;
+    }
+
+    // Keep a reference to the old table in the iterator
+    ht_itr_t *itr = __ht_create_iterator(table);
+
+    table->arraySize = newSize;
+    table->table = newTable;
+
+    // Reset the values
+    table->currentLoadFactor = 0;
+    table->numberOfItemsInTable = 0;
+    table->numberOfSlotsUsed = 0;
 
-        __ht_iterator_free(&itr);
+    for (ht_index_t i = 0; i < table->arraySize; i++)
+    {
+        table->table[i] = NULL;
+    }
+
+    // Loop through all the values in the original table, rehashing them into the new one
+    while (__ht_iterator_has_next(itr))
+    {
+        ht_entry_t *node = __ht_iterator_next(itr);
+        __ht_put_nia(table, node->key, node->value, node);
     }
+
+    // Free the old table
+    free(itr->iteratorTable);
+    
+    __ht_iterator_free(&itr);
 }
 
 
 /**
- * Halve the size of the array for holding elements in the specified HashTable
+ * Check if a table is a read-only view returned by __ht_snapshot()
  * 
- * @param table The table to be halved
+ * @param table The table to check
+ * @return true if the table is a snapshot
  */
-static void _ht_half_table(ht_t *table)
+static bool _ht_is_snapshot(ht_t *table)
 {
-    if (table != NULL && (table->arraySize) >= (2 * HT_INITIAL_SIZE))
+    // A snapshot's view is the first member of the snapshot itself
+    return (void*)(table->snapshot) == (void*)table;
+}
+
+
+/**
+ * Check if a bucket's collision list is shared with the table's snapshot
+ * 
+ * @param table The table that owns the bucket (not a snapshot)
+ * @param index The bucket to check
+ * @return true if the table may not modify the bucket's list in place
+ */
+static bool _ht_bucket_is_shared(ht_t *table, ht_index_t index)
+{
+    if (table->snapshot == NULL)
     {
-        // Keep a reference to the old table in the iterator
-        ht_itr_t *itr = __ht_create_iterator(table);
+        return false;
+    }
+    // Until the first write after the snapshot, the whole array is shared
+    if (table->sharedBuckets == NULL)
+    {
+        return true;
+    }
+    return (table->sharedBuckets[index / HT_SHARED_WORD_BITS] >> (index % HT_SHARED_WORD_BITS)) & 1UL;
+}
 
-        table->arraySize = (table->arraySize) / 2;
-        table->table = malloc(sizeof(ht_entry_t *) * table->arraySize);
 
-        // Reset the values
-        table->currentLoadFactor = 0;
-        table->numberOfItemsInTable = 0;
-        table->numberOfSlotsUsed = 0;
+/**
+ * Give a table its own copy of the bucket array that it shares with its
+ * snapshot, marking every bucket as shared. The collision lists are not
+ * copied.
+ * 
+ * @param table The table that owns the snapshot
+ * @return true on failure (memory allocation failure), false on success
+ */
+static bool _ht_cow_prepare(ht_t *table)
+{
+    size_t words = (table->arraySize + HT_SHARED_WORD_BITS - 1) / HT_SHARED_WORD_BITS;
+    ht_entry_t **newTable = malloc(sizeof(*newTable) * table->arraySize);
+    unsigned long *shared = malloc(sizeof(*shared) * words);
+    if (newTable == NULL || shared == NULL)
+    {
+        free(newTable);
+        free(shared);
+        return true;
+    }
 
-        for (ht_index_t i = 0; i < table->arraySize; i++)
+    memcpy(newTable, table->table, sizeof(*newTable) * table->arraySize);
+    memset(shared, 0xff, sizeof(*shared) * words);
+    table->table = newTable;
+    table->sharedBuckets = shared;
+    return false;
+}
+
+
+/**
+ * Replace a bucket's collision list with a private copy if it is still
+ * shared with the table's snapshot
+ * 
+ * @param table The table that owns the bucket (not a snapshot)
+ * @param index The bucket that is about to be modified
+ * @return true on failure (memory allocation failure), false on success
+ */
+static bool _ht_cow_bucket(ht_t *table, ht_index_t index)
+{
+    if (!_ht_bucket_is_shared(table, index))
+    {
+        return false;
+    }
+    if (table->sharedBuckets == NULL && _ht_cow_prepare(table))
+    {
+        return true;
+    }
+
+    ht_entry_t *copy = NULL;
+    ht_entry_t **tail = &copy;
+    for (ht_entry_t *node = table->table[index]; node != NULL; node = node->next)
+    {
+        ht_entry_t *item = malloc(sizeof(*item));
+        if (item == NULL)
         {
-            table->table[i] = NULL;
+            _ht_free_chain(copy);
+            return true;
         }
+        item->next = NULL;
+        item->key = node->key;
+        item->value = node->value;
+        *tail = item;
+        tail = &(item->next);
+    }
+
+    table->table[index] = copy;
+    table->sharedBuckets[index / HT_SHARED_WORD_BITS] &= ~(1UL << (index % HT_SHARED_WORD_BITS));
+    return false;
+}
+
 
-        // Loop through all the values in the original table, rehashing them into the new one
-        while (__ht_iterator_has_next(itr))
+/**
+ * Copy every bucket still shared with the table's snapshot and
+ * detach the snapshot from the table
+ * 
+ * @param table The table that owns the snapshot
+ * @return true on failure (memory allocation failure), false on success
+ */
+static bool _ht_unshare_all(ht_t *table)
+{
+    for (ht_index_t i = 0; i < table->arraySize; i++)
+    {
+        if (_ht_cow_bucket(table, i))
         {
-            ht_entry_t *node = __ht_iterator_next(itr);
-            __ht_put_nia(table, node->key, node->value, node);
+            return true;
         }
+    }
+    _ht_detach_snapshot(table);
+    return false;
+}
+
 
-        // Free the old table
-        free(itr->iteratorTable);
-        
-        __ht_iterator_free(&itr);
+/**
+ * Hand everything the table shares with its snapshot over to the snapshot.
+ * The caller must ensure that the table no longer references any shared
+ * bucket (or the shared array).
+ * 
+ * @param table The table that owns the snapshot
+ */
+static void _ht_detach_snapshot(ht_t *table)
+{
+    table->snapshot->owner = NULL;
+    table->snapshot = NULL;
+    free(table->sharedBuckets);
+    table->sharedBuckets = NULL;
+}
+
+
+/**
+ * Free every entry in a collision list
+ * 
+ * @param node The first entry of the list (may be NULL)
+ */
+static void _ht_free_chain(ht_entry_t *node)
+{
+    while (node != NULL)
+    {
+        ht_entry_t *next = node->next;
+        free(node);
+        node = next;
     }
 }
 
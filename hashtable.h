@@ -17,6 +17,16 @@
  *             Add return status value to put() and sput()
  * 2023-06-06: Remove reallocation of every item during
  *             table resize (added __ht_put_nia())
+ * 2026-10-18: Add __ht_get_entry() for containers built
+ *             on top of the hashtable (see ht-cache.h)
+ * 2026-10-18: Add retain() for single-pass bulk removal
+ * 2026-10-18: Add length-delimited string key functions
+ *             (snput(), snget(), snremove(), contains_snkey(),
+ *             hash_nstring()) for keys that are not NUL-terminated
+ * 2026-10-18: Add batch string hashing (hash_nstrings()) and
+ *             batch lookup (snget_batch())
+ * 2026-10-18: Add copy-on-write snapshots (snapshot(),
+ *             snapshot_release())
  * 
  * USAGE:
  * Define HT_DATA_T as the data type to be stored in the hashtable structure.
@@ -26,6 +36,23 @@
  * **NOTE**: The hashtable internally stores pointers. For example, if HT_DATA_T
  *           is defined as char, internally, the hash table would be storing
  *           char*. This is different behavior than the Stack data structure.
+ *
+ * SNAPSHOTS:
+ * snapshot() returns a read-only view of the table in O(1). The view shares
+ * the table's buckets and entries. The first time the table writes to a
+ * bucket that is still shared, it copies that bucket's collision list first,
+ * so the view keeps seeing the table as it was when the snapshot was taken.
+ * A table resize (or a clear()) copies all buckets that are still shared.
+ * Release the view with snapshot_release(), which frees the copies that
+ * only the view still references.
+ * **NOTE**: Lookups on a view may run concurrently with writes to its
+ *           table, but snapshot() and snapshot_release() must be serialized
+ *           with the writers.
+ * **NOTE**: A table has at most one snapshot at a time. Taking another
+ *           snapshot after the table has been modified detaches the old one
+ *           (which stays valid until it is released).
+ * **NOTE**: Snapshots are not supported for the tables used internally by
+ *           ht-cache and ht-expire.
  */
 
 #ifndef HT_H
@@ -40,6 +67,7 @@
 #define HT_DEFAULT_MAX_NGATIVE_LOAD_FACTOR_VARIANCE 0.5
 #define HT_DEFAULT_LOAD_FACTOR 1.0
 #define HT_INITIAL_SIZE 8
+#define HT_HASH_BATCH_LANES 16  // Keys whose buckets snget_batch() prefetches together
 
 typedef unsigned long ht_key_t;
 typedef size_t ht_index_t;
@@ -54,6 +82,8 @@ typedef struct ht_t
     ht_index_t numberOfSlotsUsed;       // Number of table slots that have had data in them ("dirty slots")
     ht_index_t arraySize;               // Current size of array to store elements
     struct ht_entry_t **table;          // The table in which to store the elements
+    struct ht_snapshot_t *snapshot;     // Snapshot sharing buckets with this table (NULL if none)
+    unsigned long *sharedBuckets;       // Bitmap of buckets still shared with the snapshot
 } ht_t;
 
 typedef struct ht_entry_t
@@ -63,6 +93,18 @@ typedef struct ht_entry_t
     void *value;
 } ht_entry_t;
 
+// Predicate for retain(): return true to keep the element
+typedef bool (*ht_retain_fn)(ht_key_t key, void *value, void *ctx);
+// Receives elements removed from the table by bulk operations
+typedef void (*ht_value_fn)(ht_key_t key, void *value, void *ctx);
+
+typedef struct ht_snapshot_t
+{
+    ht_t view;                          // MUST be first (the snapshot is used as an ht_t)
+    ht_t *owner;                        // The table the view was taken from (NULL once detached)
+    int refs;                           // Number of outstanding snapshot() calls
+} ht_snapshot_t;
+
 typedef struct ht_itr_t
 {
     int currentTableIndex;
@@ -80,16 +122,27 @@ void __ht_clear(ht_t *table);
 bool __ht_put_nia(ht_t *table, ht_key_t key, void *value, ht_entry_t *item); // Assumes item has already been allocated
 bool __ht_put(ht_t *table, ht_key_t key, void *value);
 bool __ht_sput(ht_t *table, char *key, void *value);
+bool __ht_snput(ht_t *table, const char *key, size_t len, void *value);
 void *__ht_get(ht_t *table, ht_key_t key);
+ht_entry_t *__ht_get_entry(ht_t *table, ht_key_t key);
 void *__ht_sget(ht_t *table, char *key);
+void *__ht_snget(ht_t *table, const char *key, size_t len);
 void *__ht_remove(ht_t *table, ht_key_t key);
 void *__ht_sremove(ht_t *table, char *key);
+void *__ht_snremove(ht_t *table, const char *key, size_t len);
 bool __ht_contains_key(ht_t *table, ht_key_t key);
 bool __ht_contains_skey(ht_t *table, char *key);
+bool __ht_contains_snkey(ht_t *table, const char *key, size_t len);
+ht_index_t __ht_retain(ht_t *table, ht_retain_fn keep, ht_value_fn removed, void *ctx);
 void __ht_destroy(ht_t **table);
+ht_t *__ht_snapshot(ht_t *table);
+void __ht_snapshot_release(ht_t **snapshot);
 bool __ht_is_empty(ht_t *table);
 ht_index_t __ht_get_num_elements(ht_t *table);
 ht_key_t __ht_hash_string(const char *string);
+ht_key_t __ht_hash_nstring(const char *string, size_t len);
+void __ht_hash_nstrings(const char *const *strings, const size_t *lens, ht_key_t *hashes, size_t n);
+size_t __ht_snget_batch(ht_t *table, const char *const *keys, const size_t *lens, void **values, size_t n);
 
 ht_itr_t *__ht_create_iterator(ht_t *table);
 bool __ht_iterator_has_next(ht_itr_t *itr);
@@ -118,6 +171,8 @@ typedef struct HT_T
     ht_index_t numberOfSlotsUsed;       // Number of table slots that have had data in them ("dirty slots")
     ht_index_t arraySize;               // Current size of array to store elements
     struct HT_ENTRY_T **table;          // The table in which to store the elements
+    struct ht_snapshot_t *snapshot;     // Snapshot sharing buckets with this table (NULL if none)
+    unsigned long *sharedBuckets;       // Bitmap of buckets still shared with the snapshot
 } HT_T;
 
 typedef struct HT_ENTRY_T
@@ -160,6 +215,11 @@ static inline bool HT_GLUE(HT_DATA_NAME, _ht_sput)(HT_T *t, char *k, HT_DATA_T *
     return __ht_sput((ht_t*)t, k, (void*)v);
 }
 
+static inline bool HT_GLUE(HT_DATA_NAME, _ht_snput)(HT_T *t, const char *k, size_t len, HT_DATA_T *v)
+{
+    return __ht_snput((ht_t*)t, k, len, (void*)v);
+}
+
 static inline HT_DATA_T *HT_GLUE(HT_DATA_NAME, _ht_get)(HT_T *t, ht_key_t k)
 {
     return (HT_DATA_T*)__ht_get((ht_t*)t, k);
@@ -170,6 +230,16 @@ static inline HT_DATA_T *HT_GLUE(HT_DATA_NAME, _ht_sget)(HT_T *t, char *k)
     return (HT_DATA_T*)__ht_sget((ht_t*)t, k);
 }
 
+static inline HT_DATA_T *HT_GLUE(HT_DATA_NAME, _ht_snget)(HT_T *t, const char *k, size_t len)
+{
+    return (HT_DATA_T*)__ht_snget((ht_t*)t, k, len);
+}
+
+static inline size_t HT_GLUE(HT_DATA_NAME, _ht_snget_batch)(HT_T *t, const char *const *k, const size_t *lens, HT_DATA_T **v, size_t n)
+{
+    return __ht_snget_batch((ht_t*)t, k, lens, (void**)v, n);
+}
+
 static inline HT_DATA_T *HT_GLUE(HT_DATA_NAME, _ht_remove)(HT_T *t, ht_key_t k)
 {
     return (HT_DATA_T*)__ht_remove((ht_t*)t, k);
@@ -180,6 +250,11 @@ static inline HT_DATA_T *HT_GLUE(HT_DATA_NAME, _ht_sremove)(HT_T *t, char *k)
     return (HT_DATA_T*)__ht_sremove((ht_t*)t, k);
 }
 
+static inline HT_DATA_T *HT_GLUE(HT_DATA_NAME, _ht_snremove)(HT_T *t, const char *k, size_t len)
+{
+    return (HT_DATA_T*)__ht_snremove((ht_t*)t, k, len);
+}
+
 static inline bool HT_GLUE(HT_DATA_NAME, _ht_contains_key)(HT_T *t, ht_key_t k)
 {
     return __ht_contains_key((ht_t*)t, k);
@@ -190,11 +265,31 @@ static inline bool HT_GLUE(HT_DATA_NAME, _ht_contains_skey)(HT_T *t, char *k)
     return __ht_contains_skey((ht_t*)t, k);
 }
 
+static inline bool HT_GLUE(HT_DATA_NAME, _ht_contains_snkey)(HT_T *t, const char *k, size_t len)
+{
+    return __ht_contains_snkey((ht_t*)t, k, len);
+}
+
+static inline ht_index_t HT_GLUE(HT_DATA_NAME, _ht_retain)(HT_T *t, ht_retain_fn keep, ht_value_fn removed, void *ctx)
+{
+    return __ht_retain((ht_t*)t, keep, removed, ctx);
+}
+
 static inline void HT_GLUE(HT_DATA_NAME, _ht_destroy)(HT_T **t)
 {
     __ht_destroy((ht_t**)t);
 }
 
+static inline HT_T *HT_GLUE(HT_DATA_NAME, _ht_snapshot)(HT_T *t)
+{
+    return (HT_T*)__ht_snapshot((ht_t*)t);
+}
+
+static inline void HT_GLUE(HT_DATA_NAME, _ht_snapshot_release)(HT_T **s)
+{
+    __ht_snapshot_release((ht_t**)s);
+}
+
 static inline bool HT_GLUE(HT_DATA_NAME, _ht_is_empty)(HT_T *t)
 {
     return __ht_is_empty((ht_t*)t);
@@ -210,6 +305,16 @@ static inline ht_key_t  HT_GLUE(HT_DATA_NAME, _ht_hash_string)(const char *strin
     return __ht_hash_string(string);
 }
 
+static inline ht_key_t  HT_GLUE(HT_DATA_NAME, _ht_hash_nstring)(const char *string, size_t len)
+{
+    return __ht_hash_nstring(string, len);
+}
+
+static inline void HT_GLUE(HT_DATA_NAME, _ht_hash_nstrings)(const char *const *strings, const size_t *lens, ht_key_t *hashes, size_t n)
+{
+    __ht_hash_nstrings(strings, lens, hashes, n);
+}
+
 static inline HT_ITR_T *HT_GLUE(HT_DATA_NAME, _ht_create_iterator)(HT_T *t)
 {
     return (HT_ITR_T*)__ht_create_iterator((ht_t*)t);
@@ -0,0 +1,467 @@
+/**
+ * LRU-bounded cache built on the hashtable
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-18: Initial creation
+ * 2026-10-18: Add length-delimited string key functions
+ *
+ * USAGE: see ht-cache.h
+ */
+
+#define __HTC_HTC_C
+#include "ht-cache.h"
+#undef __HTC_HTC_C
+
+// Helper functions
+static inline void _htc_lru_unlink(htc_t *cache, htc_entry_t *item);
+static inline void _htc_lru_push_front(htc_t *cache, htc_entry_t *item);
+static void _htc_enforce_capacity(htc_t *cache);
+
+
+/**
+ * Heap-allocate a new cache
+ *
+ * @param **cache Pointer to the cache
+ * @param max_entries Maximum number of entries held (0 for no limit)
+ * @param max_bytes Maximum number of bytes charged by put() (0 for no limit)
+ * @param evict Called with every entry evicted due to capacity (may be NULL)
+ * @param evict_ctx User pointer passed through to evict()
+ * @return false on success, true on failure (memory allocation failure)
+ */
+bool __htc_init(htc_t **cache, size_t max_entries, size_t max_bytes, htc_evict_fn evict, void *evict_ctx)
+{
+    *cache = malloc(sizeof(**cache));
+    if (!*cache) {
+        return true;
+    }
+    if (__ht_init(&((*cache)->table))) {
+        free(*cache);
+        *cache = NULL;
+        return true;
+    }
+    (*cache)->lru_head = NULL;
+    (*cache)->lru_tail = NULL;
+    (*cache)->max_entries = max_entries;
+    (*cache)->max_bytes = max_bytes;
+    (*cache)->bytes = 0;
+    (*cache)->hits = 0;
+    (*cache)->misses = 0;
+    (*cache)->evictions = 0;
+    (*cache)->evict = evict;
+    (*cache)->evict_ctx = evict_ctx;
+    return false;
+}
+
+
+/**
+ * Free a cache.
+ * @note This does NOT free() the values stored and does NOT call
+ *       the eviction callback
+ * @note The *cache is set to NULL
+ *
+ * @param cache The cache to free
+ */
+void __htc_destroy(htc_t **cache)
+{
+    if (cache != NULL && *cache != NULL)
+    {
+        // The LRU entries are the hashtable entries
+        __ht_destroy(&((*cache)->table));
+        free(*cache);
+        *cache = NULL;
+    }
+}
+
+
+/**
+ * Add an element to the cache, marking it as the most recently used.
+ * If the key already exists, its value and size are replaced.
+ * Assumes that you have already malloc()'d the value pointer
+ *
+ * @note Evicting to make room may evict the element that was just
+ *       added if its size alone exceeds max_bytes
+ *
+ * @param cache The cache to be operated upon
+ * @param key The key associated with the provided value
+ * @param value The value to be associated with the key
+ * @param size The number of bytes to charge against max_bytes
+ * @return true on failure, false on success
+ */
+bool __htc_put(htc_t *cache, ht_key_t key, void *value, size_t size)
+{
+    if (cache == NULL) {
+        return true;
+    }
+
+    htc_entry_t *item = (htc_entry_t*)__ht_get_entry(cache->table, key);
+    if (item) {
+        item->entry.value = value;
+        cache->bytes = cache->bytes - item->size + size;
+        item->size = size;
+        _htc_lru_unlink(cache, item);
+    }
+    else {
+        item = malloc(sizeof(*item));
+        if (!item) {
+            return true;
+        }
+        // The key is known not to exist, so the item will not be free()'d
+        if (__ht_put_nia(cache->table, key, value, (ht_entry_t*)item)) {
+            return true;
+        }
+        item->size = size;
+        cache->bytes += size;
+    }
+    _htc_lru_push_front(cache, item);
+    _htc_enforce_capacity(cache);
+    return false;
+}
+
+
+/**
+ * Add an element to the cache
+ *
+ * @param cache The cache to be operated upon
+ * @param key The key associated with the provided value
+ * @param value The value to be associated with the key
+ * @param size The number of bytes to charge against max_bytes
+ * @return true on failure, false on success
+ */
+bool __htc_sput(htc_t *cache, char *key, void *value, size_t size)
+{
+    if (cache != NULL && key != NULL)
+    {
+        return __htc_put(cache, __ht_hash_string(key), value, size);
+    }
+    return true;
+}
+
+
+/**
+ * Add an element to the cache using a length-delimited string key
+ *
+ * @param cache The cache to be operated upon
+ * @param key The first character of the key
+ * @param len The number of characters in the key
+ * @param value The value to be associated with the key
+ * @param size The number of bytes to charge against max_bytes
+ * @return true on failure, false on success
+ */
+bool __htc_snput(htc_t *cache, const char *key, size_t len, void *value, size_t size)
+{
+    if (cache != NULL && key != NULL)
+    {
+        return __htc_put(cache, __ht_hash_nstring(key, len), value, size);
+    }
+    return true;
+}
+
+
+/**
+ * Get an element from the cache and mark it as the most recently used
+ *
+ * @param cache The cache in which to search for the key
+ * @param key The key corresponsing to the value that will be returned
+ * @return The value corresponding to the key specified
+ *         (NULL if cache is NULL or it element does not exist)
+ */
+void *__htc_get(htc_t *cache, ht_key_t key)
+{
+    if (cache != NULL)
+    {
+        htc_entry_t *item = (htc_entry_t*)__ht_get_entry(cache->table, key);
+        if (item)
+        {
+            cache->hits++;
+            if (item != cache->lru_head)
+            {
+                _htc_lru_unlink(cache, item);
+                _htc_lru_push_front(cache, item);
+            }
+            return item->entry.value;
+        }
+        cache->misses++;
+    }
+    return NULL;
+}
+
+
+/**
+ * Get an element from the cache
+ *
+ * @param cache The cache in which to search for the key
+ * @param key The key corresponsing to the value that will be returned
+ * @return The value corresponding to the key specified
+ *         (NULL if cache is NULL or it element does not exist)
+ */
+void *__htc_sget(htc_t *cache, char *key)
+{
+    if (cache != NULL && key != NULL)
+    {
+        return __htc_get(cache, __ht_hash_string(key));
+    }
+    return NULL;
+}
+
+
+/**
+ * Get an element from the cache based on a length-delimited string key
+ *
+ * @param cache The cache in which to search for the key
+ * @param key The first character of the key
+ * @param len The number of characters in the key
+ * @return The value corresponding to the key specified
+ *         (NULL if cache is NULL or it element does not exist)
+ */
+void *__htc_snget(htc_t *cache, const char *key, size_t len)
+{
+    if (cache != NULL && key != NULL)
+    {
+        return __htc_get(cache, __ht_hash_nstring(key, len));
+    }
+    return NULL;
+}
+
+
+/**
+ * Get an element from the cache without updating its recency
+ * or the hit/miss counters
+ *
+ * @param cache The cache in which to search for the key
+ * @param key The key corresponsing to the value that will be returned
+ * @return The value corresponding to the key specified
+ *         (NULL if cache is NULL or it element does not exist)
+ */
+void *__htc_peek(htc_t *cache, ht_key_t key)
+{
+    if (cache != NULL)
+    {
+        return __ht_get(cache->table, key);
+    }
+    return NULL;
+}
+
+
+/**
+ * Remove an item from the cache. The eviction callback is not called.
+ *
+ * @param cache The cache from which to remove an element
+ * @param key The key for the value to be removed
+ * @return The value associated with the key, NULL if no such element exists
+ */
+void *__htc_remove(htc_t *cache, ht_key_t key)
+{
+    if (cache != NULL)
+    {
+        htc_entry_t *item = (htc_entry_t*)__ht_get_entry(cache->table, key);
+        if (item)
+        {
+            _htc_lru_unlink(cache, item);
+            cache->bytes -= item->size;
+            return __ht_remove(cache->table, key); // free()s item
+        }
+    }
+    return NULL;
+}
+
+
+/**
+ * Remove an item from the cache
+ *
+ * @param cache The cache from which to remove an element
+ * @param key The key for the value to be removed
+ * @return The value associated with the key, NULL if no such element exists
+ */
+void *__htc_sremove(htc_t *cache, char *key)
+{
+    if (cache != NULL && key != NULL)
+    {
+        return __htc_remove(cache, __ht_hash_string(key));
+    }
+    return NULL;
+}
+
+
+/**
+ * Remove an item from the cache based on a length-delimited string key
+ *
+ * @param cache The cache from which to remove an element
+ * @param key The first character of the key
+ * @param len The number of characters in the key
+ * @return The value associated with the key, NULL if no such element exists
+ */
+void *__htc_snremove(htc_t *cache, const char *key, size_t len)
+{
+    if (cache != NULL && key != NULL)
+    {
+        return __htc_remove(cache, __ht_hash_nstring(key, len));
+    }
+    return NULL;
+}
+
+
+/**
+ * Returns the number of items in the cache
+ *
+ * @param cache The cache to retrieve the number of elements from
+ * @return The number of elements in the cache (0 if cache is NULL)
+ */
+ht_index_t __htc_get_num_elements(htc_t *cache)
+{
+    if (cache != NULL)
+    {
+        return __ht_get_num_elements(cache->table);
+    }
+    return 0;
+}
+
+
+/**
+ * Returns the number of bytes currently charged to the cache
+ *
+ * @param cache The cache to check
+ * @return The sum of the sizes of all entries (0 if cache is NULL)
+ */
+size_t __htc_get_bytes(htc_t *cache)
+{
+    if (cache != NULL)
+    {
+        return cache->bytes;
+    }
+    return 0;
+}
+
+
+/**
+ * Returns the number of get() calls that found their key
+ *
+ * @param cache The cache to check
+ * @return The hit counter (0 if cache is NULL)
+ */
+size_t __htc_get_hits(htc_t *cache)
+{
+    if (cache != NULL)
+    {
+        return cache->hits;
+    }
+    return 0;
+}
+
+
+/**
+ * Returns the number of get() calls that did not find their key
+ *
+ * @param cache The cache to check
+ * @return The miss counter (0 if cache is NULL)
+ */
+size_t __htc_get_misses(htc_t *cache)
+{
+    if (cache != NULL)
+    {
+        return cache->misses;
+    }
+    return 0;
+}
+
+
+/**
+ * Returns the number of entries evicted due to capacity
+ *
+ * @param cache The cache to check
+ * @return The eviction counter (0 if cache is NULL)
+ */
+size_t __htc_get_evictions(htc_t *cache)
+{
+    if (cache != NULL)
+    {
+        return cache->evictions;
+    }
+    return 0;
+}
+
+
+/**
+ * Reset the hit, miss and eviction counters to 0
+ *
+ * @param cache The cache to reset the counters of
+ */
+void __htc_reset_stats(htc_t *cache)
+{
+    if (cache != NULL)
+    {
+        cache->hits = 0;
+        cache->misses = 0;
+        cache->evictions = 0;
+    }
+}
+
+
+/**
+ * Remove an entry from the LRU list
+ *
+ * @param cache The cache that the entry belongs to
+ * @param item The entry to unlink
+ */
+static void _htc_lru_unlink(htc_t *cache, htc_entry_t *item)
+{
+    if (item->lru_prev) {
+        item->lru_prev->lru_next = item->lru_next;
+    }
+    else {
+        cache->lru_head = item->lru_next;
+    }
+    if (item->lru_next) {
+        item->lru_next->lru_prev = item->lru_prev;
+    }
+    else {
+        cache->lru_tail = item->lru_prev;
+    }
+}
+
+
+/**
+ * Insert an entry at the most recently used end of the LRU list
+ *
+ * @param cache The cache that the entry belongs to
+ * @param item The entry to insert
+ */
+static void _htc_lru_push_front(htc_t *cache, htc_entry_t *item)
+{
+    item->lru_prev = NULL;
+    item->lru_next = cache->lru_head;
+    if (cache->lru_head) {
+        cache->lru_head->lru_prev = item;
+    }
+    else {
+        cache->lru_tail = item;
+    }
+    cache->lru_head = item;
+}
+
+
+/**
+ * Evict least recently used entries until the cache is
+ * within both its entry and byte capacity
+ *
+ * @param cache The cache to trim
+ */
+static void _htc_enforce_capacity(htc_t *cache)
+{
+    while (cache->lru_tail &&
+           ((cache->max_entries && __ht_get_num_elements(cache->table) > cache->max_entries) ||
+            (cache->max_bytes && cache->bytes > cache->max_bytes)))
+    {
+        htc_entry_t *victim = cache->lru_tail;
+        ht_key_t key = victim->entry.key;
+
+        _htc_lru_unlink(cache, victim);
+        cache->bytes -= victim->size;
+        cache->evictions++;
+
+        void *value = __ht_remove(cache->table, key); // free()s victim
+        if (cache->evict) {
+            cache->evict(key, value, cache->evict_ctx);
+        }
+    }
+}
@@ -0,0 +1,206 @@
+/**
+ * LRU-bounded cache built on the hashtable
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-18: Initial creation
+ * 2026-10-18: Add length-delimited string key functions
+ *
+ * USAGE:
+ * Define HTC_DATA_T as the data type to be stored in the cache.
+ * Define HTC_DATA_NAME as the data name for the associated function calls.
+ * **NOTE**: Do not enclose the above macros in parens! For example, if the
+ *           data type is char* , define the macros as char* , not (char*)
+ * **NOTE**: Like the hashtable, the cache internally stores pointers to
+ *           the values.
+ *
+ * The cache holds at most max_entries entries and at most max_bytes
+ * bytes (as charged by the size argument of put()). A limit of 0 disables
+ * that limit. When a put() exceeds either limit, the least recently used
+ * entries are evicted and handed to the eviction callback (if any).
+ *
+ * The LRU links live inside each hashtable entry, so a get() that hits is
+ * a single hashtable probe plus an O(1) relink.
+ */
+
+#ifndef HTC_H
+#define HTC_H
+
+#ifndef __HT_HT_C
+# define __HT_HT_C
+# define __HTC_UNDEF_HT_C
+#endif
+#include "hashtable.h"
+#ifdef __HTC_UNDEF_HT_C
+# undef __HT_HT_C
+# undef __HTC_UNDEF_HT_C
+#endif
+
+#define _HTC_GLUE(x, y) x##y
+#define HTC_GLUE(x, y) _HTC_GLUE(x, y)
+
+// Called for every entry that is evicted to make room for new entries
+typedef void (*htc_evict_fn)(ht_key_t key, void *value, void *ctx);
+
+typedef struct htc_entry_t
+{
+    ht_entry_t entry;                 // MUST be first (freed by the hashtable)
+    struct htc_entry_t *lru_prev;     // Towards the most recently used entry
+    struct htc_entry_t *lru_next;     // Towards the least recently used entry
+    size_t size;                      // Bytes charged against max_bytes
+} htc_entry_t;
+
+typedef struct htc_t
+{
+    ht_t *table;                      // Key -> htc_entry_t lookup
+    htc_entry_t *lru_head;            // Most recently used entry
+    htc_entry_t *lru_tail;            // Least recently used entry (next to be evicted)
+    size_t max_entries;               // Entry capacity (0 = unlimited)
+    size_t max_bytes;                 // Byte capacity (0 = unlimited)
+    size_t bytes;                     // Bytes currently charged
+    size_t hits;                      // Number of get() calls that found their key
+    size_t misses;                    // Number of get() calls that did not
+    size_t evictions;                 // Number of entries evicted due to capacity
+    htc_evict_fn evict;               // Eviction callback (may be NULL)
+    void *evict_ctx;                  // User context passed to evict()
+} htc_t;
+
+
+// Function Prototypes
+bool __htc_init(htc_t **cache, size_t max_entries, size_t max_bytes, htc_evict_fn evict, void *evict_ctx);
+void __htc_destroy(htc_t **cache);
+bool __htc_put(htc_t *cache, ht_key_t key, void *value, size_t size);
+bool __htc_sput(htc_t *cache, char *key, void *value, size_t size);
+bool __htc_snput(htc_t *cache, const char *key, size_t len, void *value, size_t size);
+void *__htc_get(htc_t *cache, ht_key_t key);
+void *__htc_sget(htc_t *cache, char *key);
+void *__htc_snget(htc_t *cache, const char *key, size_t len);
+void *__htc_peek(htc_t *cache, ht_key_t key);
+void *__htc_remove(htc_t *cache, ht_key_t key);
+void *__htc_sremove(htc_t *cache, char *key);
+void *__htc_snremove(htc_t *cache, const char *key, size_t len);
+ht_index_t __htc_get_num_elements(htc_t *cache);
+size_t __htc_get_bytes(htc_t *cache);
+size_t __htc_get_hits(htc_t *cache);
+size_t __htc_get_misses(htc_t *cache);
+size_t __htc_get_evictions(htc_t *cache);
+void __htc_reset_stats(htc_t *cache);
+
+#endif
+
+#ifndef __HTC_HTC_C
+
+#if !defined(HTC_DATA_T) || !defined(HTC_DATA_NAME)
+# error "Must define HTC_DATA_T and HTC_DATA_NAME before including ht-cache.h"
+#endif
+
+#define HTC_T HTC_GLUE(HTC_DATA_NAME, _htc_t)
+
+// Wrapping the untyped cache gives each generic type its own struct so
+// that mixing caches of different types is caught at compile time
+typedef struct HTC_T
+{
+    htc_t cache;
+} HTC_T;
+
+
+// "Macro Generic" templating wrappers
+static inline bool HTC_GLUE(HTC_DATA_NAME, _htc_init)(HTC_T **c, size_t max_entries, size_t max_bytes, htc_evict_fn evict, void *evict_ctx)
+{
+    return __htc_init((htc_t**)c, max_entries, max_bytes, evict, evict_ctx);
+}
+
+static inline void HTC_GLUE(HTC_DATA_NAME, _htc_destroy)(HTC_T **c)
+{
+    __htc_destroy((htc_t**)c);
+}
+
+static inline bool HTC_GLUE(HTC_DATA_NAME, _htc_put)(HTC_T *c, ht_key_t k, HTC_DATA_T *v, size_t size)
+{
+    return __htc_put((htc_t*)c, k, (void*)v, size);
+}
+
+static inline bool HTC_GLUE(HTC_DATA_NAME, _htc_sput)(HTC_T *c, char *k, HTC_DATA_T *v, size_t size)
+{
+    return __htc_sput((htc_t*)c, k, (void*)v, size);
+}
+
+static inline bool HTC_GLUE(HTC_DATA_NAME, _htc_snput)(HTC_T *c, const char *k, size_t len, HTC_DATA_T *v, size_t size)
+{
+    return __htc_snput((htc_t*)c, k, len, (void*)v, size);
+}
+
+static inline HTC_DATA_T *HTC_GLUE(HTC_DATA_NAME, _htc_get)(HTC_T *c, ht_key_t k)
+{
+    return (HTC_DATA_T*)__htc_get((htc_t*)c, k);
+}
+
+static inline HTC_DATA_T *HTC_GLUE(HTC_DATA_NAME, _htc_sget)(HTC_T *c, char *k)
+{
+    return (HTC_DATA_T*)__htc_sget((htc_t*)c, k);
+}
+
+static inline HTC_DATA_T *HTC_GLUE(HTC_DATA_NAME, _htc_snget)(HTC_T *c, const char *k, size_t len)
+{
+    return (HTC_DATA_T*)__htc_snget((htc_t*)c, k, len);
+}
+
+static inline HTC_DATA_T *HTC_GLUE(HTC_DATA_NAME, _htc_peek)(HTC_T *c, ht_key_t k)
+{
+    return (HTC_DATA_T*)__htc_peek((htc_t*)c, k);
+}
+
+static inline HTC_DATA_T *HTC_GLUE(HTC_DATA_NAME, _htc_remove)(HTC_T *c, ht_key_t k)
+{
+    return (HTC_DATA_T*)__htc_remove((htc_t*)c, k);
+}
+
+static inline HTC_DATA_T *HTC_GLUE(HTC_DATA_NAME, _htc_sremove)(HTC_T *c, char *k)
+{
+    return (HTC_DATA_T*)__htc_sremove((htc_t*)c, k);
+}
+
+static inline HTC_DATA_T *HTC_GLUE(HTC_DATA_NAME, _htc_snremove)(HTC_T *c, const char *k, size_t len)
+{
+    return (HTC_DATA_T*)__htc_snremove((htc_t*)c, k, len);
+}
+
+static inline ht_index_t HTC_GLUE(HTC_DATA_NAME, _htc_get_num_elements)(HTC_T *c)
+{
+    return __htc_get_num_elements((htc_t*)c);
+}
+
+static inline size_t HTC_GLUE(HTC_DATA_NAME, _htc_get_bytes)(HTC_T *c)
+{
+    return __htc_get_bytes((htc_t*)c);
+}
+
+static inline size_t HTC_GLUE(HTC_DATA_NAME, _htc_get_hits)(HTC_T *c)
+{
+    return __htc_get_hits((htc_t*)c);
+}
+
+static inline size_t HTC_GLUE(HTC_DATA_NAME, _htc_get_misses)(HTC_T *c)
+{
+    return __htc_get_misses((htc_t*)c);
+}
+
+static inline size_t HTC_GLUE(HTC_DATA_NAME, _htc_get_evictions)(HTC_T *c)
+{
+    return __htc_get_evictions((htc_t*)c);
+}
+
+static inline void HTC_GLUE(HTC_DATA_NAME, _htc_reset_stats)(HTC_T *c)
+{
+    __htc_reset_stats((htc_t*)c);
+}
+
+
+#undef HTC_DATA_T
+#undef HTC_DATA_NAME
+#undef HTC_T
+
+// See the note at the end of hashtable.h
+#define __HTC_HTC_C
+
+#endif
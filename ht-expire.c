@@ -0,0 +1,513 @@
+/**
+ * Hashtable with per-entry time-to-live expiry
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-18: Initial creation
+ * 2026-10-18: Add length-delimited string key functions
+ *
+ * USAGE: see ht-expire.h
+ */
+
+#define __HTE_HTE_C
+#include "ht-expire.h"
+#undef __HTE_HTE_C
+
+#define HTE_WHEEL_MASK (HTE_WHEEL_SLOTS - 1)
+#define HTE_WHEEL_RANGE ((hte_time_t)1 << (HTE_WHEEL_BITS * HTE_WHEEL_LEVELS))
+
+// Helper functions
+static inline void _hte_wheel_unlink(hte_t *table, hte_entry_t *item);
+static void _hte_wheel_insert(hte_t *table, hte_entry_t *item, hte_time_t earliest);
+static hte_time_t _hte_next_event(hte_t *table);
+static void _hte_cascade(hte_t *table);
+static void _hte_rehome(hte_t *table, hte_time_t now);
+
+
+/**
+ * Heap-allocate a new expiring hashtable
+ *
+ * @param **table Pointer to the table
+ * @param now The current time (in ticks)
+ * @param expire Called with every entry removed by expire() (may be NULL)
+ * @param expire_ctx User pointer passed through to expire()
+ * @return false on success, true on failure (memory allocation failure)
+ */
+bool __hte_init(hte_t **table, hte_time_t now, hte_expire_fn expire, void *expire_ctx)
+{
+    *table = malloc(sizeof(**table));
+    if (!*table) {
+        return true;
+    }
+    if (__ht_init(&((*table)->table))) {
+        free(*table);
+        *table = NULL;
+        return true;
+    }
+    (*table)->now = now;
+    (*table)->expire = expire;
+    (*table)->expire_ctx = expire_ctx;
+    for (int l = 0; l < HTE_WHEEL_LEVELS; l++) {
+        for (int s = 0; s < HTE_WHEEL_SLOTS; s++) {
+            (*table)->wheel[l][s] = NULL;
+        }
+        (*table)->occupied[l] = 0;
+    }
+    return false;
+}
+
+
+/**
+ * Free an expiring hashtable.
+ * @note This does NOT free() the values stored and does NOT call
+ *       the expiry callback
+ * @note The *table is set to NULL
+ *
+ * @param table The table to free
+ */
+void __hte_destroy(hte_t **table)
+{
+    if (table != NULL && *table != NULL)
+    {
+        // The wheel entries are the hashtable entries
+        __ht_destroy(&((*table)->table));
+        free(*table);
+        *table = NULL;
+    }
+}
+
+
+/**
+ * Add an element to the table that expires ttl ticks after the current
+ * table time. If the key already exists, its value and expiry are replaced.
+ * Assumes that you have already malloc()'d the value pointer
+ *
+ * @param table The table to be operated upon
+ * @param key The key associated with the provided value
+ * @param value The value to be associated with the key
+ * @param ttl The number of ticks until the entry expires. A ttl of 0 is
+ *            treated as 1 (the entry expires on the next tick).
+ * @return true on failure, false on success
+ */
+bool __hte_put(hte_t *table, ht_key_t key, void *value, hte_time_t ttl)
+{
+    if (table == NULL) {
+        return true;
+    }
+
+    hte_entry_t *item = (hte_entry_t*)__ht_get_entry(table->table, key);
+    if (item) {
+        item->entry.value = value;
+        _hte_wheel_unlink(table, item);
+    }
+    else {
+        item = malloc(sizeof(*item));
+        if (!item) {
+            return true;
+        }
+        // The key is known not to exist, so the item will not be free()'d
+        if (__ht_put_nia(table->table, key, value, (ht_entry_t*)item)) {
+            return true;
+        }
+    }
+
+    if (ttl == 0) {
+        ttl = 1;
+    }
+    // Saturate rather than wrap around for "never" style TTLs
+    item->expires = (ttl > UINT64_MAX - table->now) ? UINT64_MAX : table->now + ttl;
+    _hte_wheel_insert(table, item, table->now + 1);
+    return false;
+}
+
+
+/**
+ * Add an element to the table
+ *
+ * @param table The table to be operated upon
+ * @param key The key associated with the provided value
+ * @param value The value to be associated with the key
+ * @param ttl The number of ticks until the entry expires
+ * @return true on failure, false on success
+ */
+bool __hte_sput(hte_t *table, char *key, void *value, hte_time_t ttl)
+{
+    if (table != NULL && key != NULL)
+    {
+        return __hte_put(table, __ht_hash_string(key), value, ttl);
+    }
+    return true;
+}
+
+
+/**
+ * Add an element to the table using a length-delimited string key
+ *
+ * @param table The table to be operated upon
+ * @param key The first character of the key
+ * @param len The number of characters in the key
+ * @param value The value to be associated with the key
+ * @param ttl The number of ticks until the entry expires
+ * @return true on failure, false on success
+ */
+bool __hte_snput(hte_t *table, const char *key, size_t len, void *value, hte_time_t ttl)
+{
+    if (table != NULL && key != NULL)
+    {
+        return __hte_put(table, __ht_hash_nstring(key, len), value, ttl);
+    }
+    return true;
+}
+
+
+/**
+ * Get an element from the table based on the specified key
+ *
+ * @param table The table in which to search for the key
+ * @param key The key corresponsing to the value that will be returned
+ * @return The value corresponding to the key specified
+ *         (NULL if table is NULL or it element does not exist)
+ */
+void *__hte_get(hte_t *table, ht_key_t key)
+{
+    if (table != NULL)
+    {
+        return __ht_get(table->table, key);
+    }
+    return NULL;
+}
+
+
+/**
+ * Get an element from the table based on the specified key
+ *
+ * @param table The table in which to search for the key
+ * @param key The key corresponsing to the value that will be returned
+ * @return The value corresponding to the key specified
+ *         (NULL if table is NULL or it element does not exist)
+ */
+void *__hte_sget(hte_t *table, char *key)
+{
+    if (table != NULL && key != NULL)
+    {
+        return __ht_get(table->table, __ht_hash_string(key));
+    }
+    return NULL;
+}
+
+
+/**
+ * Get an element from the table based on a length-delimited string key
+ *
+ * @param table The table in which to search for the key
+ * @param key The first character of the key
+ * @param len The number of characters in the key
+ * @return The value corresponding to the key specified
+ *         (NULL if table is NULL or it element does not exist)
+ */
+void *__hte_snget(hte_t *table, const char *key, size_t len)
+{
+    if (table != NULL && key != NULL)
+    {
+        return __ht_get(table->table, __ht_hash_nstring(key, len));
+    }
+    return NULL;
+}
+
+
+/**
+ * Remove an item from the table before it expires. The expiry
+ * callback is not called.
+ *
+ * @param table The table from which to remove an element
+ * @param key The key for the value to be removed
+ * @return The value associated with the key, NULL if no such element exists
+ */
+void *__hte_remove(hte_t *table, ht_key_t key)
+{
+    if (table != NULL)
+    {
+        hte_entry_t *item = (hte_entry_t*)__ht_get_entry(table->table, key);
+        if (item)
+        {
+            _hte_wheel_unlink(table, item);
+            return __ht_remove(table->table, key); // free()s item
+        }
+    }
+    return NULL;
+}
+
+
+/**
+ * Remove an item from the table before it expires
+ *
+ * @param table The table from which to remove an element
+ * @param key The key for the value to be removed
+ * @return The value associated with the key, NULL if no such element exists
+ */
+void *__hte_sremove(hte_t *table, char *key)
+{
+    if (table != NULL && key != NULL)
+    {
+        return __hte_remove(table, __ht_hash_string(key));
+    }
+    return NULL;
+}
+
+
+/**
+ * Remove an item from the table based on a length-delimited string key
+ *
+ * @param table The table from which to remove an element
+ * @param key The first character of the key
+ * @param len The number of characters in the key
+ * @return The value associated with the key, NULL if no such element exists
+ */
+void *__hte_snremove(hte_t *table, const char *key, size_t len)
+{
+    if (table != NULL && key != NULL)
+    {
+        return __hte_remove(table, __ht_hash_nstring(key, len));
+    }
+    return NULL;
+}
+
+
+/**
+ * Advance the table to the specified time and remove every entry
+ * whose expiry time is <= now. Each removed entry is handed to the
+ * expiry callback after it has been removed from the table, so the
+ * callback may put() new entries.
+ *
+ * @note Times earlier than the current table time are ignored
+ *
+ * @param table The table to expire entries from
+ * @param now The current time (in ticks)
+ * @return The number of entries removed
+ */
+size_t __hte_expire(hte_t *table, hte_time_t now)
+{
+    size_t expired = 0;
+    if (table == NULL) {
+        return 0;
+    }
+
+    // Jumps larger than the wheel would lap it; re-sort everything once instead
+    if (now > table->now && now - table->now >= HTE_WHEEL_RANGE) {
+        _hte_rehome(table, now);
+    }
+
+    while (table->now < now)
+    {
+        // Jump straight to the next tick that has a slot to process or cascade
+        hte_time_t next = _hte_next_event(table);
+        if (next > now) {
+            table->now = now;
+            break;
+        }
+        table->now = next;
+        _hte_cascade(table);
+
+        hte_entry_t **slot = &(table->wheel[0][table->now & HTE_WHEEL_MASK]);
+        hte_entry_t *item;
+        while ((item = *slot) != NULL)
+        {
+            _hte_wheel_unlink(table, item);
+            if (item->expires > table->now) {
+                // Only possible for entries clamped to the top of the wheel
+                _hte_wheel_insert(table, item, table->now + 1);
+                continue;
+            }
+
+            ht_key_t key = item->entry.key;
+            void *value = __ht_remove(table->table, key); // free()s item
+            expired++;
+            if (table->expire) {
+                table->expire(key, value, table->expire_ctx);
+            }
+        }
+    }
+    return expired;
+}
+
+
+/**
+ * Returns the current time of the table (the time given to the
+ * last expire() call)
+ *
+ * @param table The table to check
+ * @return The table time (0 if table is NULL)
+ */
+hte_time_t __hte_get_time(hte_t *table)
+{
+    if (table != NULL)
+    {
+        return table->now;
+    }
+    return 0;
+}
+
+
+/**
+ * Returns the number of items in the table
+ *
+ * @param table The table to retrieve the number of elements from
+ * @return The number of elements in the table (0 if table is NULL)
+ */
+ht_index_t __hte_get_num_elements(hte_t *table)
+{
+    if (table != NULL)
+    {
+        return __ht_get_num_elements(table->table);
+    }
+    return 0;
+}
+
+
+/**
+ * Remove an entry from the wheel slot it is in
+ *
+ * @param table The table that the entry belongs to
+ * @param item The entry to unlink
+ */
+static void _hte_wheel_unlink(hte_t *table, hte_entry_t *item)
+{
+    *(item->wheel_pprev) = item->wheel_next;
+    if (item->wheel_next) {
+        item->wheel_next->wheel_pprev = item->wheel_pprev;
+    }
+    if (table->wheel[item->wheel_level][item->wheel_slot] == NULL) {
+        table->occupied[item->wheel_level] &= ~((uint64_t)1 << item->wheel_slot);
+    }
+}
+
+
+/**
+ * Place an entry into the wheel slot that covers its expiry time.
+ * Entries beyond the range of the wheel are parked in the farthest
+ * top-level slot and re-sorted when that slot cascades.
+ *
+ * @param table The table that the entry belongs to
+ * @param item The entry to insert
+ * @param earliest The earliest tick the entry may be placed at
+ */
+static void _hte_wheel_insert(hte_t *table, hte_entry_t *item, hte_time_t earliest)
+{
+    hte_time_t when = (item->expires < earliest) ? earliest : item->expires;
+    hte_time_t delta = when - table->now;
+
+    int level = 0;
+    while (level < HTE_WHEEL_LEVELS - 1 &&
+           delta >= ((hte_time_t)1 << (HTE_WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    if (delta >= HTE_WHEEL_RANGE) {
+        when = table->now + HTE_WHEEL_RANGE - 1;
+    }
+
+    unsigned short index = (when >> (HTE_WHEEL_BITS * level)) & HTE_WHEEL_MASK;
+    hte_entry_t **slot = &(table->wheel[level][index]);
+    item->wheel_level = level;
+    item->wheel_slot = index;
+    table->occupied[level] |= (uint64_t)1 << index;
+    item->wheel_next = *slot;
+    item->wheel_pprev = slot;
+    if (*slot) {
+        (*slot)->wheel_pprev = &(item->wheel_next);
+    }
+    *slot = item;
+}
+
+
+/**
+ * Find the first tick after the current time at which a non-empty
+ * slot is processed (level 0) or cascaded (upper levels)
+ *
+ * @param table The table to check
+ * @return The tick of the next event, UINT64_MAX if the wheel is empty
+ */
+static hte_time_t _hte_next_event(hte_t *table)
+{
+    hte_time_t next = UINT64_MAX;
+    for (int level = 0; level < HTE_WHEEL_LEVELS; level++)
+    {
+        uint64_t occupied = table->occupied[level];
+        if (!occupied) {
+            continue;
+        }
+
+        // Rotate so that bit 0 is the slot after the current one; slots at or
+        // before the current one are reached on the next revolution
+        int shift = HTE_WHEEL_BITS * level;
+        unsigned int current = (table->now >> shift) & HTE_WHEEL_MASK;
+        unsigned int start = (current + 1) & HTE_WHEEL_MASK;
+        uint64_t rotated = start ? (occupied >> start) | (occupied << (HTE_WHEEL_SLOTS - start)) : occupied;
+        hte_time_t distance = (hte_time_t)__builtin_ctzll(rotated) + 1;
+
+        hte_time_t event = ((table->now >> shift) + distance) << shift;
+        if (event < next) {
+            next = event;
+        }
+    }
+    return next;
+}
+
+
+/**
+ * Move the entries of every upper-level slot that starts at the
+ * current tick down towards level 0. Higher levels are cascaded
+ * first so that their entries can continue down in the same tick.
+ *
+ * @param table The table to cascade
+ */
+static void _hte_cascade(hte_t *table)
+{
+    for (int level = HTE_WHEEL_LEVELS - 1; level > 0; level--)
+    {
+        hte_time_t span = (hte_time_t)1 << (HTE_WHEEL_BITS * level);
+        if (table->now & (span - 1)) {
+            continue;
+        }
+
+        hte_entry_t **slot = &(table->wheel[level][(table->now >> (HTE_WHEEL_BITS * level)) & HTE_WHEEL_MASK]);
+        hte_entry_t *item;
+        while ((item = *slot) != NULL)
+        {
+            _hte_wheel_unlink(table, item);
+            _hte_wheel_insert(table, item, table->now);
+        }
+    }
+}
+
+
+/**
+ * Re-sort every entry relative to a time that is more than a full
+ * wheel revolution away. Entries that have already expired are placed
+ * in the level 0 slot for now so that the next tick removes them.
+ *
+ * @param table The table to re-sort
+ * @param now The new table time
+ */
+static void _hte_rehome(hte_t *table, hte_time_t now)
+{
+    hte_entry_t *pending = NULL;
+
+    // Gather all entries onto one list (reusing wheel_next)
+    for (int l = 0; l < HTE_WHEEL_LEVELS; l++) {
+        for (int s = 0; s < HTE_WHEEL_SLOTS; s++) {
+            hte_entry_t *item;
+            while ((item = table->wheel[l][s]) != NULL) {
+                _hte_wheel_unlink(table, item);
+                item->wheel_next = pending;
+                pending = item;
+            }
+        }
+    }
+
+    table->now = now - 1;
+    while (pending != NULL) {
+        hte_entry_t *item = pending;
+        pending = pending->wheel_next;
+        _hte_wheel_insert(table, item, now);
+    }
+}
@@ -0,0 +1,191 @@
+/**
+ * Hashtable with per-entry time-to-live expiry
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-18: Initial creation
+ * 2026-10-18: Add length-delimited string key functions
+ *
+ * USAGE:
+ * Define HTE_DATA_T as the data type to be stored in the table.
+ * Define HTE_DATA_NAME as the data name for the associated function calls.
+ * **NOTE**: Do not enclose the above macros in parens! For example, if the
+ *           data type is char* , define the macros as char* , not (char*)
+ * **NOTE**: Like the hashtable, the table internally stores pointers to
+ *           the values.
+ *
+ * Time is measured in caller-defined ticks (seconds, milliseconds, ...).
+ * put() takes a TTL relative to the time of the last expire() call (or
+ * the time given to init()). expire(now) advances the table to now and
+ * removes every entry whose expiry time is <= now, handing each one to
+ * the expiry callback.
+ *
+ * Entries are threaded onto a hierarchical timing wheel of HTE_WHEEL_LEVELS
+ * levels of HTE_WHEEL_SLOTS slots each. Each level keeps a bitmap of its
+ * occupied slots so that expire() jumps over empty stretches of time, doing
+ * work proportional to the number of expired (and cascaded) entries rather
+ * than to the size of the table or the number of elapsed ticks.
+ */
+
+#ifndef HTE_H
+#define HTE_H
+
+#include <stdint.h>
+
+#ifndef __HT_HT_C
+# define __HT_HT_C
+# define __HTE_UNDEF_HT_C
+#endif
+#include "hashtable.h"
+#ifdef __HTE_UNDEF_HT_C
+# undef __HT_HT_C
+# undef __HTE_UNDEF_HT_C
+#endif
+
+#define HTE_WHEEL_BITS 6     // Must stay 6: slot occupancy is a uint64_t bitmap
+#define HTE_WHEEL_SLOTS (1 << HTE_WHEEL_BITS)
+#define HTE_WHEEL_LEVELS 4
+
+#define _HTE_GLUE(x, y) x##y
+#define HTE_GLUE(x, y) _HTE_GLUE(x, y)
+
+typedef uint64_t hte_time_t;
+
+// Called for every entry removed by expire()
+typedef void (*hte_expire_fn)(ht_key_t key, void *value, void *ctx);
+
+typedef struct hte_entry_t
+{
+    ht_entry_t entry;                    // MUST be first (freed by the hashtable)
+    struct hte_entry_t *wheel_next;      // Next entry in the same wheel slot
+    struct hte_entry_t **wheel_pprev;    // The pointer that points to this entry
+    unsigned short wheel_level;          // Wheel level the entry is in
+    unsigned short wheel_slot;           // Slot within wheel_level
+    hte_time_t expires;                  // Absolute expiry time
+} hte_entry_t;
+
+typedef struct hte_t
+{
+    ht_t *table;                                             // Key -> hte_entry_t lookup
+    hte_time_t now;                                          // Current wheel time
+    hte_entry_t *wheel[HTE_WHEEL_LEVELS][HTE_WHEEL_SLOTS];   // Timing wheel slots
+    uint64_t occupied[HTE_WHEEL_LEVELS];                     // Bitmap of non-empty slots per level
+    hte_expire_fn expire;                                    // Expiry callback (may be NULL)
+    void *expire_ctx;                                        // User context passed to expire()
+} hte_t;
+
+
+// Function Prototypes
+bool __hte_init(hte_t **table, hte_time_t now, hte_expire_fn expire, void *expire_ctx);
+void __hte_destroy(hte_t **table);
+bool __hte_put(hte_t *table, ht_key_t key, void *value, hte_time_t ttl);
+bool __hte_sput(hte_t *table, char *key, void *value, hte_time_t ttl);
+bool __hte_snput(hte_t *table, const char *key, size_t len, void *value, hte_time_t ttl);
+void *__hte_get(hte_t *table, ht_key_t key);
+void *__hte_sget(hte_t *table, char *key);
+void *__hte_snget(hte_t *table, const char *key, size_t len);
+void *__hte_remove(hte_t *table, ht_key_t key);
+void *__hte_sremove(hte_t *table, char *key);
+void *__hte_snremove(hte_t *table, const char *key, size_t len);
+size_t __hte_expire(hte_t *table, hte_time_t now);
+hte_time_t __hte_get_time(hte_t *table);
+ht_index_t __hte_get_num_elements(hte_t *table);
+
+#endif
+
+#ifndef __HTE_HTE_C
+
+#if !defined(HTE_DATA_T) || !defined(HTE_DATA_NAME)
+# error "Must define HTE_DATA_T and HTE_DATA_NAME before including ht-expire.h"
+#endif
+
+#define HTE_T HTE_GLUE(HTE_DATA_NAME, _hte_t)
+
+// Wrapping the untyped table gives each generic type its own struct so
+// that mixing tables of different types is caught at compile time
+typedef struct HTE_T
+{
+    hte_t table;
+} HTE_T;
+
+
+// "Macro Generic" templating wrappers
+static inline bool HTE_GLUE(HTE_DATA_NAME, _hte_init)(HTE_T **t, hte_time_t now, hte_expire_fn expire, void *expire_ctx)
+{
+    return __hte_init((hte_t**)t, now, expire, expire_ctx);
+}
+
+static inline void HTE_GLUE(HTE_DATA_NAME, _hte_destroy)(HTE_T **t)
+{
+    __hte_destroy((hte_t**)t);
+}
+
+static inline bool HTE_GLUE(HTE_DATA_NAME, _hte_put)(HTE_T *t, ht_key_t k, HTE_DATA_T *v, hte_time_t ttl)
+{
+    return __hte_put((hte_t*)t, k, (void*)v, ttl);
+}
+
+static inline bool HTE_GLUE(HTE_DATA_NAME, _hte_sput)(HTE_T *t, char *k, HTE_DATA_T *v, hte_time_t ttl)
+{
+    return __hte_sput((hte_t*)t, k, (void*)v, ttl);
+}
+
+static inline bool HTE_GLUE(HTE_DATA_NAME, _hte_snput)(HTE_T *t, const char *k, size_t len, HTE_DATA_T *v, hte_time_t ttl)
+{
+    return __hte_snput((hte_t*)t, k, len, (void*)v, ttl);
+}
+
+static inline HTE_DATA_T *HTE_GLUE(HTE_DATA_NAME, _hte_get)(HTE_T *t, ht_key_t k)
+{
+    return (HTE_DATA_T*)__hte_get((hte_t*)t, k);
+}
+
+static inline HTE_DATA_T *HTE_GLUE(HTE_DATA_NAME, _hte_sget)(HTE_T *t, char *k)
+{
+    return (HTE_DATA_T*)__hte_sget((hte_t*)t, k);
+}
+
+static inline HTE_DATA_T *HTE_GLUE(HTE_DATA_NAME, _hte_snget)(HTE_T *t, const char *k, size_t len)
+{
+    return (HTE_DATA_T*)__hte_snget((hte_t*)t, k, len);
+}
+
+static inline HTE_DATA_T *HTE_GLUE(HTE_DATA_NAME, _hte_remove)(HTE_T *t, ht_key_t k)
+{
+    return (HTE_DATA_T*)__hte_remove((hte_t*)t, k);
+}
+
+static inline HTE_DATA_T *HTE_GLUE(HTE_DATA_NAME, _hte_sremove)(HTE_T *t, char *k)
+{
+    return (HTE_DATA_T*)__hte_sremove((hte_t*)t, k);
+}
+
+static inline HTE_DATA_T *HTE_GLUE(HTE_DATA_NAME, _hte_snremove)(HTE_T *t, const char *k, size_t len)
+{
+    return (HTE_DATA_T*)__hte_snremove((hte_t*)t, k, len);
+}
+
+static inline size_t HTE_GLUE(HTE_DATA_NAME, _hte_expire)(HTE_T *t, hte_time_t now)
+{
+    return __hte_expire((hte_t*)t, now);
+}
+
+static inline hte_time_t HTE_GLUE(HTE_DATA_NAME, _hte_get_time)(HTE_T *t)
+{
+    return __hte_get_time((hte_t*)t);
+}
+
+static inline ht_index_t HTE_GLUE(HTE_DATA_NAME, _hte_get_num_elements)(HTE_T *t)
+{
+    return __hte_get_num_elements((hte_t*)t);
+}
+
+
+#undef HTE_DATA_T
+#undef HTE_DATA_NAME
+#undef HTE_T
+
+// See the note at the end of hashtable.h
+#define __HTE_HTE_C
+
+#endif
@@ -0,0 +1,328 @@
+/**
+ * Contention benchmark for the lock-free stack
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-19: Initial creation
+ *
+ * USAGE:
+ *     gcc -std=c11 -O2 -pthread lf-stack-bench.c lf-stack.c stack.c -o lf-stack-bench -latomic
+ *     ./lf-stack-bench [pairs per thread]
+ *
+ * Runs 1, 2, 4, ... 64 threads that all push and then pop one element
+ * (a "pair") on the same stack, first on the lock-free stack and then on
+ * a Stack (stack.h) protected by a pthread mutex as the baseline. For each
+ * thread count, prints the total throughput, the time per operation and
+ * the throughput relative to one thread. The time measured is from the
+ * first thread leaving the start gate to the last thread finishing.
+ * **NOTE**: Requires POSIX threads and clock_gettime()
+ */
+
+#ifndef _DEFAULT_SOURCE
+# define _DEFAULT_SOURCE // clock_gettime() in strict C modes
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+#define LFSTACK_DATA_T long
+#define LFSTACK_DATA_NAME long
+#include "lf-stack.h"
+
+#define STACK_DATA_T long
+#define STACK_DATA_NAME long
+#include "stack.h"
+
+#define BENCH_DEFAULT_PAIRS 200000
+#define BENCH_MAX_THREADS 64
+// Elements on the stack before timing starts, so pops do not run it dry
+#define BENCH_PREFILL 1024
+
+typedef struct bench_t {
+    const char *name;
+    bool (*setup)(void);
+    void (*teardown)(void);
+    bool (*pair)(long value);              // Push one element and pop one
+} bench_t;
+
+typedef struct bench_thread_t {
+    pthread_t thread;
+    long pairs;
+    const bench_t *bench;
+    double start;                          // When the thread left the start gate
+    double end;                            // When the thread finished
+    bool failed;
+} bench_thread_t;
+
+typedef enum bench_start_t {
+    BENCH_WAIT,                            // Threads are still being created
+    BENCH_GO,
+    BENCH_ABORT                            // Creating a thread failed
+} bench_start_t;
+
+// Holds the threads until all of them have been created
+static pthread_mutex_t start_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t start_cond = PTHREAD_COND_INITIALIZER;
+static bench_start_t start_state;
+static long_lfstack_t *lf_stack;
+static long_stack_t *locked_stack;
+static pthread_mutex_t stack_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Helper functions
+static bool _lf_setup(void);
+static void _lf_teardown(void);
+static bool _lf_pair(long value);
+static bool _locked_setup(void);
+static void _locked_teardown(void);
+static bool _locked_pair(long value);
+static bool _start_wait(void);
+static void _start_release(bench_start_t state);
+static void *_bench_thread(void *arg);
+static double _bench_run(const bench_t *bench, int threads, long pairs);
+static double _now(void);
+
+
+int main(int argc, char **argv)
+{
+    static const bench_t benches[] = {
+        {"lfstack", _lf_setup, _lf_teardown, _lf_pair},
+        {"mutex+stack", _locked_setup, _locked_teardown, _locked_pair},
+    };
+    long pairs = argc > 1 ? atol(argv[1]) : BENCH_DEFAULT_PAIRS;
+    if (pairs <= 0) {
+        fprintf(stderr, "usage: %s [pairs per thread]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%-12s %7s %12s %9s %8s\n", "stack", "threads", "Mops/s", "ns/op", "scaling");
+    for (size_t b = 0; b < sizeof(benches) / sizeof(benches[0]); b++) {
+        double single = 0.0;
+        for (int threads = 1; threads <= BENCH_MAX_THREADS; threads *= 2) {
+            double seconds = _bench_run(&benches[b], threads, pairs);
+            if (seconds < 0) {
+                fprintf(stderr, "%s: failed with %d threads\n", benches[b].name, threads);
+                return 1;
+            }
+            double ops = 2.0 * (double)pairs * threads;
+            double rate = ops / seconds;
+            if (threads == 1) {
+                single = rate;
+            }
+            printf("%-12s %7d %12.2f %9.1f %7.2fx\n", benches[b].name, threads,
+                   rate / 1e6, seconds * 1e9 / ops, rate / single);
+        }
+    }
+    return 0;
+}
+
+
+/**
+ * Run one benchmark with a number of threads
+ *
+ * @param bench The benchmark
+ * @param threads The number of threads
+ * @param pairs The number of push/pop pairs per thread
+ * @return The wall clock time in seconds, negative on failure
+ */
+static double _bench_run(const bench_t *bench, int threads, long pairs)
+{
+    bench_thread_t workers[BENCH_MAX_THREADS];
+    bool failed = false;
+    int created;
+
+    if (bench->setup()) {
+        return -1.0;
+    }
+    start_state = BENCH_WAIT;
+    for (created = 0; created < threads; created++) {
+        workers[created].pairs = pairs;
+        workers[created].bench = bench;
+        workers[created].start = 0.0;
+        workers[created].end = 0.0;
+        workers[created].failed = false;
+        if (pthread_create(&workers[created].thread, NULL, _bench_thread, &workers[created])) {
+            failed = true;
+            break;
+        }
+    }
+    // Let the threads run, or make the ones already created exit
+    _start_release(failed ? BENCH_ABORT : BENCH_GO);
+
+    double start = 0.0, end = 0.0;
+    for (int i = 0; i < created; i++) {
+        pthread_join(workers[i].thread, NULL);
+        failed |= workers[i].failed;
+        if (i == 0 || workers[i].start < start) {
+            start = workers[i].start;
+        }
+        if (workers[i].end > end) {
+            end = workers[i].end;
+        }
+    }
+    double seconds = end - start;
+
+    bench->teardown();
+    return failed ? -1.0 : seconds;
+}
+
+
+/**
+ * Wait until _start_release() is called
+ *
+ * @return false to run, true if the run was aborted
+ */
+static bool _start_wait(void)
+{
+    pthread_mutex_lock(&start_lock);
+    while (start_state == BENCH_WAIT) {
+        pthread_cond_wait(&start_cond, &start_lock);
+    }
+    bool aborted = (start_state == BENCH_ABORT);
+    pthread_mutex_unlock(&start_lock);
+    return aborted;
+}
+
+
+/**
+ * Release the threads waiting in _start_wait()
+ *
+ * @param state BENCH_GO to run, BENCH_ABORT to make them exit
+ */
+static void _start_release(bench_start_t state)
+{
+    pthread_mutex_lock(&start_lock);
+    start_state = state;
+    pthread_cond_broadcast(&start_cond);
+    pthread_mutex_unlock(&start_lock);
+}
+
+
+/**
+ * Benchmark thread: wait for the others to be created, then run the pairs
+ *
+ * @param arg The thread's bench_thread_t
+ * @return NULL
+ */
+static void *_bench_thread(void *arg)
+{
+    bench_thread_t *worker = arg;
+
+    if (_start_wait()) {
+        return NULL;
+    }
+    worker->start = _now();
+    for (long i = 0; i < worker->pairs; i++) {
+        if (worker->bench->pair(i)) {
+            worker->failed = true;
+            break;
+        }
+    }
+    worker->end = _now();
+    return NULL;
+}
+
+
+/**
+ * Create the lock-free stack and prefill it
+ *
+ * @return false on success, true on memory allocation failure
+ */
+static bool _lf_setup(void)
+{
+    if (long_lfstack_init(&lf_stack)) {
+        return true;
+    }
+    for (long i = 0; i < BENCH_PREFILL; i++) {
+        if (long_lfstack_push(lf_stack, i)) {
+            long_lfstack_destroy(&lf_stack);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * Free the lock-free stack
+ */
+static void _lf_teardown(void)
+{
+    long_lfstack_destroy(&lf_stack);
+}
+
+
+/**
+ * Push an element onto the lock-free stack and pop one
+ *
+ * @param value The element to push
+ * @return false on success, true on failure
+ */
+static bool _lf_pair(long value)
+{
+    return long_lfstack_push(lf_stack, value) || long_lfstack_pop(lf_stack, &value);
+}
+
+
+/**
+ * Create the mutex-protected stack and prefill it
+ *
+ * @return false on success, true on memory allocation failure
+ */
+static bool _locked_setup(void)
+{
+    if (long_stack_init(&locked_stack, BENCH_PREFILL, STACK_ALLOW_SHRINK)) {
+        return true;
+    }
+    for (long i = 0; i < BENCH_PREFILL; i++) {
+        if (long_stack_push(locked_stack, i)) {
+            long_stack_destroy(&locked_stack);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * Free the mutex-protected stack
+ */
+static void _locked_teardown(void)
+{
+    long_stack_destroy(&locked_stack);
+}
+
+
+/**
+ * Push an element onto the mutex-protected stack and pop one, taking the
+ * lock for each operation
+ *
+ * @param value The element to push
+ * @return false on success, true on failure
+ */
+static bool _locked_pair(long value)
+{
+    pthread_mutex_lock(&stack_lock);
+    bool error = long_stack_push(locked_stack, value);
+    pthread_mutex_unlock(&stack_lock);
+    if (error) {
+        return true;
+    }
+    pthread_mutex_lock(&stack_lock);
+    error = long_stack_pop(locked_stack, &value);
+    pthread_mutex_unlock(&stack_lock);
+    return error;
+}
+
+
+/**
+ * Read the monotonic clock
+ *
+ * @return The time in seconds
+ */
+static double _now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
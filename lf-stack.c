@@ -0,0 +1,296 @@
+/**
+ * Lock-free concurrent stack (Treiber stack) in c
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-18: Initial creation
+ * 2026-10-19: Use a (pointer, counter) pair for the list tops instead
+ *             of packing a 16 bit tag into the pointer
+ *
+ * USAGE: see lf-stack.h
+ */
+
+#include <stdlib.h>
+#include <string.h> // memcpy()
+
+#define __LFSTACK_LFSTACK_C
+#include "lf-stack.h"
+#undef __LFSTACK_LFSTACK_C
+
+// Helper functions
+static inline lfstack_top_t _lfstack_tagged(lfstack_node_t *node, lfstack_top_t previous);
+static void _lfstack_push_chain(_Atomic lfstack_top_t *top, lfstack_node_t *first, lfstack_node_t *last);
+static lfstack_node_t *_lfstack_pop_node(_Atomic lfstack_top_t *top);
+static lfstack_node_t *_lfstack_alloc_node(lfstack_t *stack, size_t element_size);
+static void _lfstack_free_chain(lfstack_node_t *node);
+
+
+/**
+ * Heap-allocate a new lock-free stack
+ *
+ * @param **stack Pointer to the stack
+ * @return false on success, true on failure (memory allocation failure)
+ */
+bool __lfstack_init(lfstack_t **stack)
+{
+    *stack = aligned_alloc(LFSTACK_CACHE_LINE, sizeof(**stack));
+    if (!*stack) {
+        return true;
+    }
+    lfstack_top_t empty = {NULL, 0};
+    atomic_init(&((*stack)->head), empty);
+    atomic_init(&((*stack)->spare), empty);
+    return false;
+}
+
+
+/**
+ * Free a lock-free stack along with all of its nodes.
+ * @note Must not be called while other threads use the stack
+ * @note The *stack is set to NULL
+ *
+ * @param **stack The stack to free
+ */
+void __lfstack_destroy(lfstack_t **stack)
+{
+    if (!stack || !*stack) {
+        return;
+    }
+    _lfstack_free_chain(atomic_load(&((*stack)->head)).node);
+    _lfstack_free_chain(atomic_load(&((*stack)->spare)).node);
+    free(*stack);
+    *stack = NULL;
+}
+
+
+/**
+ * Returns if there are any elements in the stack
+ * @note With other threads using the stack, the result may be
+ *       outdated by the time it is returned
+ *
+ * @param stack The stack to check if empty
+ * @return True if there are 0 elements in the stack,
+ *         False if not empty or if NULL stack
+ */
+bool __lfstack_is_empty(lfstack_t *stack)
+{
+    if (stack != NULL)
+    {
+        return atomic_load_explicit(&(stack->head), memory_order_relaxed).node == NULL;
+    }
+    return 0;
+}
+
+
+/**
+ * Push an item onto the top of the stack
+ *
+ * @param *stack The stack to push the item onto
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @param *element The data to push onto the stack
+ * @return false on success, true on failure (memory allocation failure)
+ */
+bool __lfstack_push(lfstack_t *stack, size_t element_size, const void *element)
+{
+    lfstack_node_t *node = _lfstack_alloc_node(stack, element_size);
+    if (!node) {
+        return true;
+    }
+    memcpy(node->data, element, element_size);
+    _lfstack_push_chain(&(stack->head), node, node);
+    return false;
+}
+
+
+/**
+ * Push a block of items onto the stack with a single atomic update.
+ * Other threads never see only part of the block. elements[n - 1]
+ * ends up on the top of the stack.
+ *
+ * @param *stack The stack to push the items onto
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @param *elements The n items to push
+ * @param n The number of items to push
+ * @return false on success, true on failure (memory allocation failure
+ *         or null *elements pointer). Nothing is pushed on failure.
+ */
+bool __lfstack_push_list(lfstack_t *stack, size_t element_size, const void *elements, size_t n)
+{
+    if (n == 0) {
+        return false;
+    }
+    if (!elements) {
+        return true;
+    }
+
+    // Link the nodes privately, top first
+    lfstack_node_t *first = NULL;
+    lfstack_node_t *last = NULL;
+    for (size_t i = 0; i < n; i++) {
+        lfstack_node_t *node = _lfstack_alloc_node(stack, element_size);
+        if (!node) {
+            if (first) {
+                _lfstack_push_chain(&(stack->spare), first, last);
+            }
+            return true;
+        }
+        memcpy(node->data, (const char *)elements + (element_size * i), element_size);
+        atomic_store_explicit(&(node->next), first, memory_order_relaxed);
+        if (!last) {
+            last = node;
+        }
+        first = node;
+    }
+
+    _lfstack_push_chain(&(stack->head), first, last);
+    return false;
+}
+
+
+/**
+ * Remove the top element on the stack and return its value
+ *
+ * @param *stack The stack to remove the element from
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @param *element A pointer to the location to store the pop'd value
+ * @return false on success, true on empty stack or null *element pointer
+ */
+bool __lfstack_pop(lfstack_t *stack, size_t element_size, void *element)
+{
+    if (!element) {
+        return true;
+    }
+    lfstack_node_t *node = _lfstack_pop_node(&(stack->head));
+    if (!node) {
+        return true;
+    }
+    memcpy(element, node->data, element_size);
+    _lfstack_push_chain(&(stack->spare), node, node);
+    return false;
+}
+
+
+/**
+ * Remove every element from the stack with a single atomic update and
+ * hand them to fn(), starting with the top element
+ *
+ * @param *stack The stack to empty
+ * @param fn Called with a pointer to every removed element (may be NULL).
+ *           The pointer is only valid for the duration of the call.
+ * @param ctx User pointer passed through to fn()
+ * @return The number of elements removed
+ */
+size_t __lfstack_pop_all(lfstack_t *stack, lfstack_fn fn, void *ctx)
+{
+    lfstack_top_t old = atomic_load_explicit(&(stack->head), memory_order_relaxed);
+    do {
+        if (!old.node) {
+            return 0;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&(stack->head), &old, _lfstack_tagged(NULL, old),
+                                                    memory_order_acquire, memory_order_relaxed));
+
+    // The detached chain is now private to this thread
+    lfstack_node_t *first = old.node;
+    lfstack_node_t *last = first;
+    size_t count = 0;
+    for (lfstack_node_t *node = first; node; node = atomic_load_explicit(&(node->next), memory_order_relaxed)) {
+        if (fn) {
+            fn(node->data, ctx);
+        }
+        last = node;
+        count++;
+    }
+
+    _lfstack_push_chain(&(stack->spare), first, last);
+    return count;
+}
+
+
+/**
+ * Build the list top that replaces previous
+ *
+ * @param node The new top node
+ * @param previous The list top being replaced
+ * @return node with the tag of previous plus one
+ */
+static lfstack_top_t _lfstack_tagged(lfstack_node_t *node, lfstack_top_t previous)
+{
+    lfstack_top_t top = {node, previous.tag + 1};
+    return top;
+}
+
+
+/**
+ * Atomically push a linked chain of nodes onto a tagged list
+ *
+ * @param top The list to push onto
+ * @param first The node that becomes the top of the list
+ * @param last The last node in the chain starting at first
+ */
+static void _lfstack_push_chain(_Atomic lfstack_top_t *top, lfstack_node_t *first, lfstack_node_t *last)
+{
+    lfstack_top_t old = atomic_load_explicit(top, memory_order_relaxed);
+    do {
+        atomic_store_explicit(&(last->next), old.node, memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(top, &old, _lfstack_tagged(first, old),
+                                                    memory_order_release, memory_order_relaxed));
+}
+
+
+/**
+ * Atomically pop the top node off of a tagged list
+ *
+ * @param top The list to pop from
+ * @return The node, NULL if the list is empty
+ */
+static lfstack_node_t *_lfstack_pop_node(_Atomic lfstack_top_t *top)
+{
+    lfstack_top_t old = atomic_load_explicit(top, memory_order_acquire);
+    lfstack_node_t *node;
+    do {
+        node = old.node;
+        if (!node) {
+            return NULL;
+        }
+        // node may be popped (and even reused) by another thread before
+        // the compare-and-swap, in which case next is stale. The tag makes
+        // the compare-and-swap fail in that case. Nodes are never free()'d
+        // while the stack is in use, so the read itself is always safe.
+    } while (!atomic_compare_exchange_weak_explicit(top, &old,
+                                                    _lfstack_tagged(atomic_load_explicit(&(node->next), memory_order_relaxed), old),
+                                                    memory_order_acquire, memory_order_acquire));
+    return node;
+}
+
+
+/**
+ * Get a node for a new element, reusing a previously popped node if possible
+ *
+ * @param *stack The stack the node is for
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @return The node, NULL on memory allocation failure
+ */
+static lfstack_node_t *_lfstack_alloc_node(lfstack_t *stack, size_t element_size)
+{
+    lfstack_node_t *node = _lfstack_pop_node(&(stack->spare));
+    if (node) {
+        return node;
+    }
+    return malloc(sizeof(*node) + element_size);
+}
+
+
+/**
+ * Free every node in a chain
+ *
+ * @param node The first node of the chain (may be NULL)
+ */
+static void _lfstack_free_chain(lfstack_node_t *node)
+{
+    while (node) {
+        lfstack_node_t *next = atomic_load_explicit(&(node->next), memory_order_relaxed);
+        free(node);
+        node = next;
+    }
+}
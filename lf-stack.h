@@ -0,0 +1,134 @@
+/**
+ * Lock-free concurrent stack (Treiber stack) in c
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-18: Initial creation
+ * 2026-10-19: Pair the top pointer with a full word modification counter
+ *             (double-width compare-and-swap) instead of a 16 bit tag
+ *
+ * USAGE:
+ * Define LFSTACK_DATA_T as the data type to be stored in the stack structure.
+ * Define LFSTACK_DATA_NAME as the data name for the associated function calls.
+ * **NOTE**: Do not enclose the above macros in parens! For example, if the
+ *           data type is char* , define the macros as char* , not (char*)
+ * **NOTE**: Like the Stack data structure, elements are stored by value.
+ *
+ * push(), push_list(), pop(), pop_all() and is_empty() may be called from
+ * any number of threads at once. init() and destroy() may not.
+ *
+ * The top of the stack is a pointer paired with a modification counter
+ * that is a full word wide, and the pair is updated with a double-width
+ * compare-and-swap. The counter is incremented by every update, so a
+ * pop() that was delayed while its node was popped and pushed again fails
+ * its compare-and-swap (the ABA problem). The counter only repeats after
+ * 2^64 updates on 64 bit targets (2^32 on 32 bit targets), far longer
+ * than any thread can be delayed. Popped nodes are kept on an internal
+ * free list for reuse instead of being free()'d, so a delayed pop() never
+ * reads freed memory. All nodes are free()'d by destroy().
+ * **NOTE**: Requires C11 atomics (<stdatomic.h>). On 64 bit targets the
+ *           16 byte compare-and-swap comes from libatomic with GCC, so
+ *           link with -latomic (it uses cmpxchg16b on x86-64 and
+ *           casp/ldxp on AArch64 when the CPU supports them)
+ */
+
+#include <stddef.h> // size_t, max_align_t
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#ifndef LFSTACK_H
+#define LFSTACK_H
+
+#define LFSTACK_CACHE_LINE 64
+
+#define _LFSTACK_GLUE(x, y) x##y
+#define LFSTACK_GLUE(x, y) _LFSTACK_GLUE(x, y)
+
+// Called by pop_all() with every element, in pop order
+typedef void (*lfstack_fn)(void *element, void *ctx);
+
+typedef struct lfstack_node_t {
+    _Atomic(struct lfstack_node_t *) next; // The node below this one
+    max_align_t data[];                    // The element
+} lfstack_node_t;
+
+// The top of a list, changed as one unit by compare-and-swap
+typedef struct lfstack_top_t {
+    lfstack_node_t *node;                  // The top node (NULL if empty)
+    uintptr_t tag;                         // Incremented by every update
+} lfstack_top_t;
+
+typedef struct lfstack_t {
+    _Alignas(LFSTACK_CACHE_LINE) _Atomic lfstack_top_t head;  // The top node
+    _Alignas(LFSTACK_CACHE_LINE) _Atomic lfstack_top_t spare; // The free node list
+} lfstack_t;
+
+bool __lfstack_init(lfstack_t **stack);
+void __lfstack_destroy(lfstack_t **stack);
+bool __lfstack_is_empty(lfstack_t *stack);
+bool __lfstack_push(lfstack_t *stack, size_t element_size, const void *element);
+bool __lfstack_push_list(lfstack_t *stack, size_t element_size, const void *elements, size_t n);
+bool __lfstack_pop(lfstack_t *stack, size_t element_size, void *element);
+size_t __lfstack_pop_all(lfstack_t *stack, lfstack_fn fn, void *ctx);
+
+#endif
+
+// Now on to the "type generic weirdness"
+#ifndef __LFSTACK_LFSTACK_C
+
+#if !defined(LFSTACK_DATA_NAME) || !defined(LFSTACK_DATA_T)
+# error "Must define both LFSTACK_DATA_NAME and LFSTACK_DATA_T before including lf-stack.h"
+#endif
+
+#define __LFSTACK_T LFSTACK_GLUE(LFSTACK_DATA_NAME, _lfstack_t)
+
+// Wrapping the untyped stack gives each generic type its own struct so
+// that mixing stacks of different types is caught at compile time
+typedef struct __LFSTACK_T {
+    lfstack_t stack;
+} __LFSTACK_T;
+
+// Function prototypes
+static inline bool LFSTACK_GLUE(LFSTACK_DATA_NAME, _lfstack_init)(__LFSTACK_T **stack)
+{
+    return __lfstack_init((lfstack_t**)stack);
+}
+
+static inline void LFSTACK_GLUE(LFSTACK_DATA_NAME, _lfstack_destroy)(__LFSTACK_T **stack)
+{
+    __lfstack_destroy((lfstack_t**)stack);
+}
+
+static inline bool LFSTACK_GLUE(LFSTACK_DATA_NAME, _lfstack_is_empty)(__LFSTACK_T *stack)
+{
+    return __lfstack_is_empty((lfstack_t*)stack);
+}
+
+static inline bool LFSTACK_GLUE(LFSTACK_DATA_NAME, _lfstack_push)(__LFSTACK_T *stack, LFSTACK_DATA_T element)
+{
+    return __lfstack_push((lfstack_t*)stack, sizeof(LFSTACK_DATA_T), (const void *)&element);
+}
+
+static inline bool LFSTACK_GLUE(LFSTACK_DATA_NAME, _lfstack_push_list)(__LFSTACK_T *stack, const LFSTACK_DATA_T *elements, size_t n)
+{
+    return __lfstack_push_list((lfstack_t*)stack, sizeof(LFSTACK_DATA_T), (const void *)elements, n);
+}
+
+static inline bool LFSTACK_GLUE(LFSTACK_DATA_NAME, _lfstack_pop)(__LFSTACK_T *stack, LFSTACK_DATA_T *element)
+{
+    return __lfstack_pop((lfstack_t*)stack, sizeof(LFSTACK_DATA_T), (void *)element);
+}
+
+// fn receives a LFSTACK_DATA_T* for every element
+static inline size_t LFSTACK_GLUE(LFSTACK_DATA_NAME, _lfstack_pop_all)(__LFSTACK_T *stack, lfstack_fn fn, void *ctx)
+{
+    return __lfstack_pop_all((lfstack_t*)stack, fn, ctx);
+}
+
+#undef LFSTACK_DATA_T
+#undef LFSTACK_DATA_NAME
+#undef __LFSTACK_T
+
+#endif
+
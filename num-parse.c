@@ -7,14 +7,107 @@
  * 2023-03-03: Update formating and add number base
  *             argument to int and uint parsers
  * 2024-01-23: Rename numberparser -> num-parse
+ * 2026-10-19: Parse integers in a single pass without strtol() (locale
+ *             independent, 8 digits at a time for base 10)
+ * 2026-10-19: Parse doubles without strtod() (Eisel-Lemire with a big
+ *             decimal fallback, correctly rounded)
+ * 2026-10-19: Add length-delimited strn_to_*() parsers and 64 bit parsers
+ * 2026-10-19: Add full range 32 and 64 bit parsers that do not use errno
+ * 2026-10-19: Only pass inf, nan and 0x numbers to strtod() (it accepts the
+ *             locale's decimal point), reset errno in string_to_double()
  */
 
+#include <float.h>  // FLT_EVAL_METHOD
+#include <string.h> // memcpy(), memmove()
+
 #include "num-parse.h"
+#include "num-parse-pow5.h"
+
+// Convert 8 decimal digits at a time (SWAR) on little endian targets
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+# define NP_SWAR
+#endif
+
+// Exact double arithmetic (for the fast path of string_to_double()) needs
+// doubles to be evaluated as doubles, not in extended precision
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+# define NP_FAST_PATH
+#endif
+
+// Passed as the length of a NUL-terminated string
+#define NP_NUL_TERMINATED SIZE_MAX
+
+// Infinity, NaN and hexadecimal numbers in a buffer that is not
+// NUL-terminated are copied to a temporary string of this size for strtod()
+#define NP_STRTOD_BUFFER 128
+
+// Significant digits kept for the fast double conversions (any 19 digit
+// number fits in 64 bits)
+#define NP_MANTISSA_DIGITS 19
+// Exponents larger than this overflow or underflow anyway (even after
+// adding the number of digits in the string)
+#define NP_EXPONENT_LIMIT (INT64_C(1) << 40)
+#define NP_DOUBLE_MANTISSA_BITS 52
+#define NP_DOUBLE_INFINITY (UINT64_C(0x7FF) << NP_DOUBLE_MANTISSA_BITS)
+#define NP_DOUBLE_SIGN (UINT64_C(1) << 63)
+
+// Big decimal for the double conversions that cannot be done with 64 bits
+// (800 digits are enough to round any double correctly)
+#define NP_DECIMAL_DIGITS 800
+#define NP_DECIMAL_MAX_SHIFT 60
+
+typedef struct np_decimal_t {
+    uint8_t digits[NP_DECIMAL_DIGITS + 20]; // Digit values, most significant first (the
+                                            // extra room is used by left shifts)
+    int count;                              // Number of digits
+    int point;                              // Position of the decimal point
+    bool truncated;                         // Nonzero digits were dropped after the last digit
+} np_decimal_t;
+
+// Helper functions
+static inline bool _np_is_space(char c);
+static inline unsigned int _np_digit_value(char c);
+static inline bool _np_mul_add_overflow(uint64_t *acc, uint64_t base, uint64_t digit);
+#ifdef NP_SWAR
+static inline uint64_t _np_load8(const char *string);
+static inline bool _np_is_eight_digits(uint64_t chunk);
+static inline uint32_t _np_parse_eight_digits(uint64_t chunk);
+#endif
+static bool _np_parse_decimal(const char *string, size_t len, size_t *i, uint64_t *magnitude);
+static bool _np_parse_digits(const char *string, size_t len, size_t *i, unsigned int base, uint64_t *magnitude);
+static NPError _np_parse_integer(const char *string, size_t len, int base,
+                                 uint64_t max_positive, uint64_t max_negative,
+                                 bool *negative, uint64_t *magnitude, size_t *consumed);
+static NPError _np_parse_signed(int64_t *value, const char *string, size_t len,
+                                size_t *consumed, int base, int64_t max);
+static NPError _np_parse_unsigned(uint64_t *value, const char *string, size_t len,
+                                  size_t *consumed, int base, uint64_t max);
+static inline uint64_t _np_mul128(uint64_t a, uint64_t b, uint64_t *high);
+static inline int _np_leading_zeros(uint64_t x);
+static size_t _np_scan_significand(const char *string, size_t len, size_t *i,
+                                   uint64_t *significand, int *digits, bool *truncated);
+static uint64_t _np_eisel_lemire(int64_t q, uint64_t w, bool *tiny);
+static void _np_decimal_set(np_decimal_t *decimal, const char *string, size_t len, int64_t exponent);
+static void _np_decimal_trim(np_decimal_t *decimal);
+static void _np_decimal_left_shift(np_decimal_t *decimal, unsigned int k);
+static void _np_decimal_right_shift(np_decimal_t *decimal, unsigned int k);
+static void _np_decimal_shift(np_decimal_t *decimal, int k);
+static uint64_t _np_decimal_rounded_integer(const np_decimal_t *decimal);
+static uint64_t _np_decimal_to_bits(np_decimal_t *decimal, bool *underflow);
+static NPError _np_parse_double(const char *string, size_t len, double *value, size_t *consumed);
+static bool _np_has_prefix(const char *string, size_t len, const char *prefix);
+static NPError _np_strtod(double *value, const char *string, size_t len, size_t *consumed);
 
 
 /**
- * Get an integer from a string. Only base 10 allowed.
- * Based on: https://stackoverflow.com/questions/7021725/how-to-convert-a-string-to-integer-in-c
+ * Get an integer from a string.
+ * Leading whitespace and a sign are skipped, and the number ends at the
+ * first character that is not a digit in the base (like strtol(), but
+ * independent of the locale). Bases 2 to 36 are supported, and base 16
+ * numbers may start with 0x. With base 0, the base is picked from the
+ * prefix (0x for 16, 0 for 8, otherwise 10).
+ * errno is set to 0 on entry, and to ERANGE if the number is out of range
+ * (strn_to_int() and the fixed-size parsers never use errno).
  * 
  * @param value The location to store the parsed number from the input string
  * @param string The string to parse for an integer
@@ -23,55 +116,30 @@
  * @return
  *      NP_SUCCESS          -   Returned if the string was successfully parsed
  *      NP_INVALID_STRING   -   Returned if the input string is NULL or 0-length
+ *                              (or only whitespace)
  *      NP_TOO_LARGE        -   Returned if the parsed value from the input string 
- *                              is larger than INT_MAX
+ *                              is larger than INT_MAX (value is set to INT_MAX
+ *                              and errno to ERANGE)
  *      NP_TOO_SMALL        -   Returned if the parsed value from the input string
- *                              is smaller than INT_MIN
+ *                              is smaller than INT_MIN (value is set to INT_MIN
+ *                              and errno to ERANGE)
+ *      NP_NON_NUMERIC      -   Returned if there are no digits in the base or
+ *                              the base is not supported
  */
 NPError string_to_int(int *value, const char *string, int base)
 {
-    *value = 0;
-   
-    // Make sure that the string is "actually a string"
-    if (is_whitespace(string)) {
-        return NP_INVALID_STRING;
-    }
-    
-    char *endPtr;
     errno = 0;
-    long parsed_value = strtol(string, &endPtr, base);
-
-    if (endPtr == string) {
-        return NP_NON_NUMERIC;
-    }
-
-    *value = parsed_value;
-    
-    if (errno == ERANGE) {
-        if (parsed_value == LONG_MAX) {
-            return NP_TOO_LARGE;
-        }
-        return NP_TOO_SMALL;
-    }
-    
-    // INT_MAX can == INT_LONG on some archetures, hence the separate "IF"
-    if (parsed_value > INT_MAX) {
-        errno = ERANGE;
-        return NP_TOO_LARGE;
-    }
-    
-    if (parsed_value < INT_MIN) {
+    NPError error = strn_to_int(value, string, NP_NUL_TERMINATED, NULL, base);
+    if (error == NP_TOO_LARGE || error == NP_TOO_SMALL) {
         errno = ERANGE;
-        return NP_TOO_SMALL;
     }
-
-    return NP_SUCCESS;
+    return error;
 }
 
 
 /**
  * Get an unsigned integer from a string.
- * Note: Maximum value is INT_MAX, not UINT_MAX
+ * Note: Maximum value is INT_MAX, not UINT_MAX (see string_to_uint32())
  * 
  * @param value The location to store the parsed number from the input string
  * @param string The string to parse for an integer
@@ -95,46 +163,261 @@ NPError string_to_uint(int *value, const char *string, int base)
 
 /**
  * Get a floating-point number from a string.
+ * Decimal numbers are converted without strtod(): the result is the
+ * correctly rounded double (the same as strtod() in the C locale), and '.'
+ * is the decimal point no matter the locale. Only infinity, NaN and
+ * hexadecimal numbers (text starting with inf, nan or 0x after the sign,
+ * in any case) are still passed to strtod().
+ * errno is set to 0 on entry, and to ERANGE on range errors
+ * (strn_to_double() never uses errno).
  * 
  * @param value The location to store the parsed number from the input string
  * @param string The string to parse for an double
  * @return
  *      NP_SUCCESS          -   Returned if the string was successfully parsed
  *      NP_INVALID_STRING   -   Returned if the input string is NULL or 0-length
- *      NP_TOO_LARGE        -   Returned if the parsed value from the input string 
- *                              is larger than INT_MAX
- *      NP_TOO_SMALL        -   Returned if the parsed value from the input string
- *                              is smaller than INT_MIN
- * 
+ *                              (or only whitespace)
+ *      NP_TOO_LARGE        -   Returned if the number is larger than the
+ *                              largest double (value is set to HUGE_VAL and
+ *                              errno to ERANGE)
+ *      NP_TOO_SMALL        -   Returned if the number is smaller than
+ *                              -HUGE_VAL (value is set to -HUGE_VAL) or too
+ *                              close to 0 to be stored exactly as a normal
+ *                              double (value is set to the rounded subnormal
+ *                              or 0). errno is set to ERANGE
+ *      NP_NON_NUMERIC      -   Returned if there is no number
  */
 NPError string_to_double(double *value, const char *string)
 {
-    *value = 0.0;
+    errno = 0;
+    NPError error = strn_to_double(value, string, NP_NUL_TERMINATED, NULL);
+    if (error == NP_TOO_LARGE || error == NP_TOO_SMALL) {
+        errno = ERANGE;
+    }
+    return error;
+}
 
-    // Make sure that the string is "actually a string"
-    if (is_whitespace(string))
-        return NP_INVALID_STRING;
 
-    char *endPtr;
-    errno = 0;
-    double parsed_value = strtod(string, &endPtr); // Base 10
+/**
+ * Get an integer from the first len characters of a buffer, which does not
+ * need to be NUL-terminated (parsing also stops at a NUL). Works like
+ * string_to_int(), but errno is never changed.
+ * 
+ * @param value The location to store the parsed number
+ * @param string The buffer to parse for an integer
+ * @param len The number of characters in the buffer
+ * @param consumed Set to the number of characters up to the end of the
+ *                 number (so the next field starts at string + *consumed),
+ *                 0 if there is no number. May be NULL
+ * @param base The number base
+ * 
+ * For return values, see string_to_int()
+ */
+NPError strn_to_int(int *value, const char *string, size_t len, size_t *consumed, int base)
+{
+    bool negative;
+    uint64_t magnitude;
 
-    if (endPtr == string) {
-        return NP_NON_NUMERIC;
-    }
+    NPError error = _np_parse_integer(string, len, base,
+                                      (uint64_t)INT_MAX, (uint64_t)INT_MAX + 1,
+                                      &negative, &magnitude, consumed);
+    *value = negative ? (int)(-(int64_t)magnitude) : (int)magnitude;
+    return error;
+}
 
-    *value = parsed_value;
-    if (errno == ERANGE)
-    {
-        if (parsed_value == HUGE_VAL) {
-            return NP_TOO_LARGE;
-        }
 
-        // HUGE_VAL has a sign
-        return NP_TOO_SMALL;
+/**
+ * Get an unsigned integer from the first len characters of a buffer.
+ * Note: Maximum value is INT_MAX, not UINT_MAX (see strn_to_uint32())
+ * 
+ * @param value The location to store the parsed number
+ * @param string The buffer to parse for an integer
+ * @param len The number of characters in the buffer
+ * @param consumed See strn_to_int()
+ * @param base The number base
+ * 
+ * For return values, see string_to_uint()
+ */
+NPError strn_to_uint(int *value, const char *string, size_t len, size_t *consumed, int base)
+{
+    NPError error = strn_to_int(value, string, len, consumed, base);
+    if (!error && *value < 0) {
+        return NP_UNEXPECTED_NEGATIVE;
     }
+    return error;
+}
 
-    return NP_SUCCESS;
+
+/**
+ * Get a 32 bit integer from a string.
+ * Unlike string_to_int(), errno is never changed.
+ * 
+ * @param value The location to store the parsed number
+ * @param string The string to parse for an integer
+ * @param base The number base
+ * 
+ * For return values, see string_to_int() (the range is INT32_MIN to
+ * INT32_MAX)
+ */
+NPError string_to_int32(int32_t *value, const char *string, int base)
+{
+    return strn_to_int32(value, string, NP_NUL_TERMINATED, NULL, base);
+}
+
+
+/**
+ * Get an unsigned 32 bit integer (full range) from a string.
+ * Unlike string_to_uint(), errno is never changed.
+ * 
+ * @param value The location to store the parsed number
+ * @param string The string to parse for an integer
+ * @param base The number base
+ * 
+ * For return values, see strn_to_uint64() (the maximum is UINT32_MAX)
+ */
+NPError string_to_uint32(uint32_t *value, const char *string, int base)
+{
+    return strn_to_uint32(value, string, NP_NUL_TERMINATED, NULL, base);
+}
+
+
+/**
+ * Get a 64 bit integer from a string. errno is never changed.
+ * 
+ * @param value The location to store the parsed number
+ * @param string The string to parse for an integer
+ * @param base The number base
+ * 
+ * For return values, see string_to_int() (the range is INT64_MIN to
+ * INT64_MAX)
+ */
+NPError string_to_int64(int64_t *value, const char *string, int base)
+{
+    return strn_to_int64(value, string, NP_NUL_TERMINATED, NULL, base);
+}
+
+
+/**
+ * Get an unsigned 64 bit integer (full range) from a string. errno is
+ * never changed.
+ * 
+ * @param value The location to store the parsed number
+ * @param string The string to parse for an integer
+ * @param base The number base
+ * 
+ * For return values, see strn_to_uint64()
+ */
+NPError string_to_uint64(uint64_t *value, const char *string, int base)
+{
+    return strn_to_uint64(value, string, NP_NUL_TERMINATED, NULL, base);
+}
+
+
+/**
+ * Get a 32 bit integer from the first len characters of a buffer
+ * 
+ * @param value The location to store the parsed number
+ * @param string The buffer to parse for an integer
+ * @param len The number of characters in the buffer
+ * @param consumed See strn_to_int()
+ * @param base The number base
+ * 
+ * For return values, see string_to_int() (the range is INT32_MIN to
+ * INT32_MAX, and errno is never changed)
+ */
+NPError strn_to_int32(int32_t *value, const char *string, size_t len, size_t *consumed, int base)
+{
+    int64_t parsed;
+    NPError error = _np_parse_signed(&parsed, string, len, consumed, base, INT32_MAX);
+    *value = (int32_t)parsed;
+    return error;
+}
+
+
+/**
+ * Get an unsigned 32 bit integer (full range) from the first len
+ * characters of a buffer
+ * 
+ * @param value The location to store the parsed number
+ * @param string The buffer to parse for an integer
+ * @param len The number of characters in the buffer
+ * @param consumed See strn_to_int()
+ * @param base The number base
+ * 
+ * For return values, see strn_to_uint64() (the maximum is UINT32_MAX)
+ */
+NPError strn_to_uint32(uint32_t *value, const char *string, size_t len, size_t *consumed, int base)
+{
+    uint64_t parsed;
+    NPError error = _np_parse_unsigned(&parsed, string, len, consumed, base, UINT32_MAX);
+    *value = (uint32_t)parsed;
+    return error;
+}
+
+
+/**
+ * Get a 64 bit integer from the first len characters of a buffer
+ * 
+ * @param value The location to store the parsed number
+ * @param string The buffer to parse for an integer
+ * @param len The number of characters in the buffer
+ * @param consumed See strn_to_int()
+ * @param base The number base
+ * 
+ * For return values, see string_to_int() (the range is INT64_MIN to
+ * INT64_MAX, and errno is never changed)
+ */
+NPError strn_to_int64(int64_t *value, const char *string, size_t len, size_t *consumed, int base)
+{
+    return _np_parse_signed(value, string, len, consumed, base, INT64_MAX);
+}
+
+
+/**
+ * Get an unsigned 64 bit integer (full range) from the first len characters
+ * of a buffer
+ * 
+ * @param value The location to store the parsed number
+ * @param string The buffer to parse for an integer
+ * @param len The number of characters in the buffer
+ * @param consumed See strn_to_int()
+ * @param base The number base
+ * 
+ * For return values, see string_to_int() (the maximum is UINT64_MAX, and
+ * errno is never changed)
+ * 
+ * Additional return values:
+ *      NP_UNEXPECTED_NEGATIVE  -   Returned if the number has a minus sign
+ *                                  (value is set to 0, "-0" is allowed)
+ */
+NPError strn_to_uint64(uint64_t *value, const char *string, size_t len, size_t *consumed, int base)
+{
+    return _np_parse_unsigned(value, string, len, consumed, base, UINT64_MAX);
+}
+
+
+/**
+ * Get a floating-point number from the first len characters of a buffer,
+ * which does not need to be NUL-terminated (parsing also stops at a NUL).
+ * Works like string_to_double(), but errno is never changed.
+ * **NOTE**: Infinity, NaN and hexadecimal numbers are copied to a
+ *           temporary string for strtod(), so only their first 127
+ *           characters are parsed.
+ * 
+ * @param value The location to store the parsed number
+ * @param string The buffer to parse for a double
+ * @param len The number of characters in the buffer
+ * @param consumed See strn_to_int()
+ * 
+ * For return values, see string_to_double()
+ */
+NPError strn_to_double(double *value, const char *string, size_t len, size_t *consumed)
+{
+    NPError error = _np_parse_double(string, len, value, consumed);
+    if (error == NP_NON_NUMERIC) {
+        return _np_strtod(value, string, len, consumed);
+    }
+    return error;
 }
 
 
@@ -202,3 +485,1024 @@ void np_perr(NPError err)
     }
 }
 
+
+/**
+ * Check if a character is whitespace (in the C locale)
+ * 
+ * @param c The character
+ * @return true if c is whitespace
+ */
+static bool _np_is_space(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+
+/**
+ * Get the value of a digit (0-9, then a-z or A-Z for 10-35)
+ * 
+ * @param c The character
+ * @return The value of the digit, 36 or more if c is not a digit
+ */
+static unsigned int _np_digit_value(char c)
+{
+    unsigned int digit = (unsigned char)c - '0';
+    if (digit < 10) {
+        return digit;
+    }
+    unsigned int letter = ((unsigned char)c | 0x20) - 'a';
+    return letter < 26 ? letter + 10 : 36;
+}
+
+
+/**
+ * Compute acc * base + digit, checking for overflow
+ * 
+ * @param acc The accumulator (not changed on overflow)
+ * @param base The multiplier
+ * @param digit The number to add
+ * @return true on overflow, false otherwise
+ */
+static bool _np_mul_add_overflow(uint64_t *acc, uint64_t base, uint64_t digit)
+{
+    uint64_t result;
+#if defined(__GNUC__) || defined(__clang__)
+    if (__builtin_mul_overflow(*acc, base, &result) ||
+        __builtin_add_overflow(result, digit, &result)) {
+        return true;
+    }
+#else
+    if (*acc > (UINT64_MAX - digit) / base) {
+        return true;
+    }
+    result = *acc * base + digit;
+#endif
+    *acc = result;
+    return false;
+}
+
+
+#ifdef NP_SWAR
+/**
+ * Load 8 characters into a 64 bit word (the first character in the low byte)
+ * 
+ * @param string The characters (at least 8 must be readable)
+ * @return The word
+ */
+static uint64_t _np_load8(const char *string)
+{
+    uint64_t chunk;
+    memcpy(&chunk, string, sizeof(chunk));
+    return chunk;
+}
+
+
+/**
+ * Check if all 8 characters in a word are decimal digits
+ * 
+ * @param chunk The characters, as loaded by _np_load8()
+ * @return true if all 8 are '0' ... '9'
+ */
+static bool _np_is_eight_digits(uint64_t chunk)
+{
+    // Each byte must be 0x30 ... 0x39: the high nibble is 3, and adding 6
+    // to the low nibble does not carry into the high nibble
+    return ((chunk & UINT64_C(0xF0F0F0F0F0F0F0F0)) |
+            (((chunk + UINT64_C(0x0606060606060606)) & UINT64_C(0xF0F0F0F0F0F0F0F0)) >> 4))
+           == UINT64_C(0x3333333333333333);
+}
+
+
+/**
+ * Convert 8 decimal digits to a number with three multiplications,
+ * combining pairs of digits, then pairs of pairs and so on
+ * 
+ * @param chunk The digits, as loaded by _np_load8()
+ * @return The value of the digits (0 ... 99999999)
+ */
+static uint32_t _np_parse_eight_digits(uint64_t chunk)
+{
+    chunk = ((chunk & UINT64_C(0x0F0F0F0F0F0F0F0F)) * 2561) >> 8;
+    chunk = ((chunk & UINT64_C(0x00FF00FF00FF00FF)) * 6553601) >> 16;
+    return (uint32_t)(((chunk & UINT64_C(0x0000FFFF0000FFFF)) * UINT64_C(42949672960001)) >> 32);
+}
+#endif
+
+
+/**
+ * Parse a run of decimal digits. All digits are consumed, even if the
+ * number does not fit in 64 bits.
+ * 
+ * @param string The string
+ * @param len The length of the string (NP_NUL_TERMINATED if NUL-terminated)
+ * @param i The index of the first digit, set to the index after the last digit
+ * @param magnitude Set to the value of the digits (if they fit in 64 bits)
+ * @return true if the value does not fit in 64 bits, false otherwise
+ */
+static bool _np_parse_decimal(const char *string, size_t len, size_t *i, uint64_t *magnitude)
+{
+    size_t start = *i;
+    size_t end = start;
+
+    // Find the end of the digits. 8 characters at a time can only be read
+    // when the length is known
+#ifdef NP_SWAR
+    if (len != NP_NUL_TERMINATED) {
+        while (len - end >= 8 && _np_is_eight_digits(_np_load8(string + end))) {
+            end += 8;
+        }
+    }
+#endif
+    while (end < len && (unsigned char)(string[end] - '0') < 10) {
+        end++;
+    }
+    *i = end;
+
+    while (start < end && string[start] == '0') {
+        start++;
+    }
+
+    // Up to 19 digits always fit in 64 bits, 21 or more never do
+    size_t digits = end - start;
+    if (digits > 20) {
+        return true;
+    }
+    size_t safe_end = digits == 20 ? end - 1 : end;
+    uint64_t acc = 0;
+#ifdef NP_SWAR
+    while (safe_end - start >= 8) {
+        acc = acc * 100000000 + _np_parse_eight_digits(_np_load8(string + start));
+        start += 8;
+    }
+#endif
+    while (start < safe_end) {
+        acc = acc * 10 + (uint64_t)(string[start++] - '0');
+    }
+    if (safe_end != end && _np_mul_add_overflow(&acc, 10, (uint64_t)(string[start] - '0'))) {
+        return true;
+    }
+    *magnitude = acc;
+    return false;
+}
+
+
+/**
+ * Parse a run of digits in any base from 2 to 36. All digits are consumed,
+ * even if the number does not fit in 64 bits.
+ * 
+ * @param string The string
+ * @param len The length of the string (NP_NUL_TERMINATED if NUL-terminated)
+ * @param i The index of the first digit, set to the index after the last digit
+ * @param base The number base
+ * @param magnitude Set to the value of the digits (if they fit in 64 bits)
+ * @return true if the value does not fit in 64 bits, false otherwise
+ */
+static bool _np_parse_digits(const char *string, size_t len, size_t *i, unsigned int base, uint64_t *magnitude)
+{
+    size_t index = *i;
+    uint64_t acc = 0;
+    bool overflow = false;
+    unsigned int digit;
+
+    while (index < len && (digit = _np_digit_value(string[index])) < base) {
+        overflow |= _np_mul_add_overflow(&acc, base, digit);
+        index++;
+    }
+    *i = index;
+    *magnitude = acc;
+    return overflow;
+}
+
+
+/**
+ * Parse an integer: leading whitespace, an optional sign, an optional base
+ * prefix and digits. The number ends at the first character that is not a
+ * digit in the base.
+ * 
+ * @param string The string to parse (may be NULL)
+ * @param len The length of the string (NP_NUL_TERMINATED if NUL-terminated)
+ * @param base The number base (0 or 2 ... 36)
+ * @param max_positive The largest allowed positive magnitude
+ * @param max_negative The largest allowed negative magnitude
+ * @param negative Set to whether the number has a minus sign
+ * @param magnitude Set to the absolute value of the number (clamped to
+ *                  max_positive or max_negative on range errors)
+ * @param consumed Set to the number of characters up to the end of the
+ *                 number, 0 if there is no number (may be NULL)
+ * @return NP_SUCCESS, NP_INVALID_STRING, NP_NON_NUMERIC, NP_TOO_LARGE or
+ *         NP_TOO_SMALL (see string_to_int())
+ */
+static NPError _np_parse_integer(const char *string, size_t len, int base,
+                                 uint64_t max_positive, uint64_t max_negative,
+                                 bool *negative, uint64_t *magnitude, size_t *consumed)
+{
+    size_t i = 0;
+
+    *negative = false;
+    *magnitude = 0;
+    if (consumed) {
+        *consumed = 0;
+    }
+
+    if (!string) {
+        return NP_INVALID_STRING;
+    }
+    while (i < len && _np_is_space(string[i])) {
+        i++;
+    }
+    if (i == len || string[i] == '\0') {
+        return NP_INVALID_STRING;
+    }
+    if (base < 0 || base == 1 || base > 36) {
+        return NP_NON_NUMERIC;
+    }
+
+    if (string[i] == '-' || string[i] == '+') {
+        *negative = string[i] == '-';
+        i++;
+    }
+
+    // A 0x prefix only counts if a hex digit follows it (otherwise the
+    // number is just the 0)
+    if ((base == 0 || base == 16) && len - i > 2 && string[i] == '0' &&
+        (string[i + 1] | 0x20) == 'x' && _np_digit_value(string[i + 2]) < 16) {
+        base = 16;
+        i += 2;
+    }
+    else if (base == 0) {
+        base = (i < len && string[i] == '0') ? 8 : 10;
+    }
+
+    size_t digits_start = i;
+    bool overflow = base == 10
+        ? _np_parse_decimal(string, len, &i, magnitude)
+        : _np_parse_digits(string, len, &i, (unsigned int)base, magnitude);
+    if (i == digits_start) {
+        *negative = false;
+        return NP_NON_NUMERIC;
+    }
+    if (consumed) {
+        *consumed = i;
+    }
+
+    if (*negative) {
+        if (overflow || *magnitude > max_negative) {
+            *magnitude = max_negative;
+            return NP_TOO_SMALL;
+        }
+    }
+    else if (overflow || *magnitude > max_positive) {
+        *magnitude = max_positive;
+        return NP_TOO_LARGE;
+    }
+    return NP_SUCCESS;
+}
+
+
+
+/**
+ * Parse a signed integer in the range -max - 1 ... max (errno is not used)
+ * 
+ * @param value Set to the number (clamped on range errors, 0 on other errors)
+ * @param string The string to parse (may be NULL)
+ * @param len The length of the string (NP_NUL_TERMINATED if NUL-terminated)
+ * @param consumed See _np_parse_integer() (may be NULL)
+ * @param base The number base
+ * @param max The largest allowed number
+ * @return See string_to_int()
+ */
+static NPError _np_parse_signed(int64_t *value, const char *string, size_t len,
+                                size_t *consumed, int base, int64_t max)
+{
+    bool negative;
+    uint64_t magnitude;
+
+    NPError error = _np_parse_integer(string, len, base, (uint64_t)max, (uint64_t)max + 1,
+                                      &negative, &magnitude, consumed);
+    // -(INT64_MAX + 1) cannot be negated in 64 bits
+    *value = negative && magnitude ? -(int64_t)(magnitude - 1) - 1 : (int64_t)magnitude;
+    return error;
+}
+
+
+/**
+ * Parse an unsigned integer in the range 0 ... max (errno is not used)
+ * 
+ * @param value Set to the number (clamped on NP_TOO_LARGE, 0 on other errors)
+ * @param string The string to parse (may be NULL)
+ * @param len The length of the string (NP_NUL_TERMINATED if NUL-terminated)
+ * @param consumed See _np_parse_integer() (may be NULL)
+ * @param base The number base
+ * @param max The largest allowed number
+ * @return See strn_to_uint64()
+ */
+static NPError _np_parse_unsigned(uint64_t *value, const char *string, size_t len,
+                                  size_t *consumed, int base, uint64_t max)
+{
+    bool negative;
+
+    NPError error = _np_parse_integer(string, len, base, max, UINT64_MAX,
+                                      &negative, value, consumed);
+    if (negative && (*value || error == NP_TOO_SMALL)) {
+        *value = 0;
+        return NP_UNEXPECTED_NEGATIVE;
+    }
+    return error;
+}
+
+/**
+ * Multiply two 64 bit numbers into a 128 bit result
+ * 
+ * @param a The first factor
+ * @param b The second factor
+ * @param high Set to the high 64 bits of the product
+ * @return The low 64 bits of the product
+ */
+static uint64_t _np_mul128(uint64_t a, uint64_t b, uint64_t *high)
+{
+#ifdef __SIZEOF_INT128__
+    __extension__ unsigned __int128 product = (unsigned __int128)a * b;
+    *high = (uint64_t)(product >> 64);
+    return (uint64_t)product;
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    *high = a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+    return (cross << 32) | (uint32_t)lo_lo;
+#endif
+}
+
+
+/**
+ * Count the leading zero bits of a number
+ * 
+ * @param x The number (not 0)
+ * @return The number of zero bits above the highest set bit
+ */
+static int _np_leading_zeros(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(x);
+#else
+    int count = 0;
+    while (!(x & NP_DOUBLE_SIGN)) {
+        x <<= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+
+/**
+ * Accumulate a run of decimal digits into a significand. Leading zeros
+ * are skipped and only the first NP_MANTISSA_DIGITS significant digits are
+ * kept, all other digits are consumed and counted.
+ * 
+ * @param string The string
+ * @param len The length of the string (NP_NUL_TERMINATED if NUL-terminated)
+ * @param i The index of the first digit, set to the index after the last digit
+ * @param significand The digits kept so far, updated with the new digits
+ * @param digits The number of digits kept so far, updated
+ * @param truncated Set to true if a nonzero digit is not kept
+ * @return The number of digits that were not kept
+ */
+static size_t _np_scan_significand(const char *string, size_t len, size_t *i,
+                                   uint64_t *significand, int *digits, bool *truncated)
+{
+    size_t index = *i;
+    uint64_t acc = *significand;
+    int count = *digits;
+    size_t dropped = 0;
+    unsigned int digit;
+
+    if (count == 0) {
+        while (index < len && string[index] == '0') {
+            index++;
+        }
+    }
+#ifdef NP_SWAR
+    if (len != NP_NUL_TERMINATED) {
+        uint64_t chunk;
+        while (count <= NP_MANTISSA_DIGITS - 8 && len - index >= 8 &&
+               _np_is_eight_digits(chunk = _np_load8(string + index))) {
+            acc = acc * 100000000 + _np_parse_eight_digits(chunk);
+            count += 8;
+            index += 8;
+        }
+    }
+#endif
+    for (; index < len && (digit = (unsigned char)string[index] - '0') < 10; index++) {
+        if (count < NP_MANTISSA_DIGITS) {
+            acc = acc * 10 + digit;
+            count++;
+        }
+        else {
+            dropped++;
+            *truncated |= digit != 0;
+        }
+    }
+
+    *i = index;
+    *significand = acc;
+    *digits = count;
+    return dropped;
+}
+
+
+/**
+ * Find the double closest to w * 10^q with the Eisel-Lemire algorithm:
+ * w is multiplied by a 128 bit approximation of 5^q, which is always
+ * precise enough to round correctly when w is exact.
+ * 
+ * @param q The decimal exponent
+ * @param w The decimal significand
+ * @param tiny Set to true if w * 10^q is not 0 but less than DBL_MIN
+ * @return The bits of the (positive) double. Infinity if too large, a
+ *         subnormal or 0 if too small
+ */
+static uint64_t _np_eisel_lemire(int64_t q, uint64_t w, bool *tiny)
+{
+    *tiny = w != 0;
+    if (w == 0 || q < NP_SMALLEST_POWER_OF_TEN) {
+        return 0;
+    }
+    *tiny = false;
+    if (q > NP_LARGEST_POWER_OF_TEN) {
+        return NP_DOUBLE_INFINITY;
+    }
+
+    int lz = _np_leading_zeros(w);
+    w <<= lz;
+
+    // 55 bits of the product are needed (mantissa, implicit bit, rounding
+    // bit and one more to see ties). If the bits below those are all ones,
+    // a carry from the low half of 5^q could change them
+    const uint64_t *power = np_power_of_five_128 + 2 * (q - NP_SMALLEST_POWER_OF_TEN);
+    uint64_t high;
+    uint64_t low = _np_mul128(w, power[0], &high);
+    if ((high & 0x1FF) == 0x1FF) {
+        uint64_t carry;
+        _np_mul128(w, power[1], &carry);
+        low += carry;
+        if (carry > low) {
+            high++;
+        }
+    }
+
+    int upper_bit = (int)(high >> 63);
+    int shift = upper_bit + 64 - NP_DOUBLE_MANTISSA_BITS - 3;
+    uint64_t mantissa = high >> shift;
+    // floor(q * log2(10)) + 63, the binary exponent of 10^q (normalized)
+    int power2 = (int)(((217706 * q) >> 16) + 63) + upper_bit - lz + 1023;
+
+    if (power2 <= 0) {
+        *tiny = true;
+        // Subnormal: shift out the bits below the smallest exponent. 5^q
+        // is never exact here, so there are no ties to round to even
+        if (-power2 + 1 >= 64) {
+            return 0;
+        }
+        mantissa >>= -power2 + 1;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        // Rounding up to 2^52 gives the smallest normal number, which has
+        // the same bits
+        return mantissa;
+    }
+
+    // Halfway between two doubles (only possible when 5^q is exact in
+    // 64 bits): round down to even instead of up
+    if (low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 &&
+        (mantissa << shift) == high) {
+        mantissa &= ~UINT64_C(1);
+    }
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= UINT64_C(2) << NP_DOUBLE_MANTISSA_BITS) {
+        mantissa = UINT64_C(1) << NP_DOUBLE_MANTISSA_BITS;
+        power2++;
+    }
+    mantissa &= ~(UINT64_C(1) << NP_DOUBLE_MANTISSA_BITS);
+    if (power2 >= 0x7FF) {
+        return NP_DOUBLE_INFINITY;
+    }
+    return mantissa | ((uint64_t)power2 << NP_DOUBLE_MANTISSA_BITS);
+}
+
+
+/**
+ * Load the digits of a decimal number into a big decimal
+ * 
+ * @param decimal The big decimal
+ * @param string The digits, with an optional '.'
+ * @param len The number of characters
+ * @param exponent The power of 10 to multiply the digits by
+ */
+static void _np_decimal_set(np_decimal_t *decimal, const char *string, size_t len, int64_t exponent)
+{
+    int64_t point = 0;
+    bool fraction = false;
+
+    decimal->count = 0;
+    decimal->truncated = false;
+
+    for (size_t i = 0; i < len; i++) {
+        char c = string[i];
+        if (c == '.') {
+            fraction = true;
+        }
+        else if (decimal->count == 0 && c == '0') {
+            // Leading zeros only move the point in the fraction
+            if (fraction) {
+                point--;
+            }
+        }
+        else {
+            if (!fraction) {
+                point++;
+            }
+            if (decimal->count < NP_DECIMAL_DIGITS) {
+                decimal->digits[decimal->count++] = (uint8_t)(c - '0');
+            }
+            else if (c != '0') {
+                decimal->truncated = true;
+            }
+        }
+    }
+
+    // Anything past +-330 is 0 or infinity, so the point can be clamped
+    point += exponent;
+    decimal->point = point > 100000 ? 100000 : point < -100000 ? -100000 : (int)point;
+    _np_decimal_trim(decimal);
+}
+
+
+/**
+ * Remove trailing zeros from a big decimal
+ * 
+ * @param decimal The big decimal
+ */
+static void _np_decimal_trim(np_decimal_t *decimal)
+{
+    while (decimal->count > 0 && decimal->digits[decimal->count - 1] == 0) {
+        decimal->count--;
+    }
+    if (decimal->count == 0) {
+        decimal->point = 0;
+    }
+}
+
+
+/**
+ * Multiply a big decimal by 2^k
+ * 
+ * @param decimal The big decimal
+ * @param k The shift (at most NP_DECIMAL_MAX_SHIFT)
+ */
+static void _np_decimal_left_shift(np_decimal_t *decimal, unsigned int k)
+{
+    // The product has at most ceil(k * log10(2)) more digits. Write it
+    // from the end, then move it to the front
+    int new_digits = (int)(k * 30103 / 100000) + 1;
+    int r = decimal->count;
+    int w = decimal->count + new_digits;
+    uint64_t n = 0;
+
+    while (r > 0) {
+        n += (uint64_t)decimal->digits[--r] << k;
+        uint64_t quotient = n / 10;
+        decimal->digits[--w] = (uint8_t)(n - quotient * 10);
+        n = quotient;
+    }
+    while (n > 0) {
+        uint64_t quotient = n / 10;
+        decimal->digits[--w] = (uint8_t)(n - quotient * 10);
+        n = quotient;
+    }
+
+    // w is now the number of unused digits at the front
+    new_digits -= w;
+    int count = decimal->count + new_digits;
+    memmove(decimal->digits, decimal->digits + w, (size_t)count);
+    if (count > NP_DECIMAL_DIGITS) {
+        for (int i = NP_DECIMAL_DIGITS; i < count; i++) {
+            decimal->truncated |= decimal->digits[i] != 0;
+        }
+        count = NP_DECIMAL_DIGITS;
+    }
+    decimal->count = count;
+    decimal->point += new_digits;
+    _np_decimal_trim(decimal);
+}
+
+
+/**
+ * Divide a big decimal by 2^k
+ * 
+ * @param decimal The big decimal
+ * @param k The shift (at most NP_DECIMAL_MAX_SHIFT)
+ */
+static void _np_decimal_right_shift(np_decimal_t *decimal, unsigned int k)
+{
+    int r = 0;
+    int w = 0;
+    uint64_t n = 0;
+    uint64_t mask = (UINT64_C(1) << k) - 1;
+
+    // Pick up enough leading digits for the first output digit
+    for (; (n >> k) == 0; r++) {
+        if (r >= decimal->count) {
+            if (n == 0) {
+                decimal->count = 0;
+                decimal->point = 0;
+                return;
+            }
+            while ((n >> k) == 0) {
+                n *= 10;
+                r++;
+            }
+            break;
+        }
+        n = n * 10 + decimal->digits[r];
+    }
+    decimal->point -= r - 1;
+
+    // Pick up a digit, put down a digit
+    for (; r < decimal->count; r++) {
+        uint8_t digit = decimal->digits[r];
+        decimal->digits[w++] = (uint8_t)(n >> k);
+        n = (n & mask) * 10 + digit;
+    }
+
+    // Put down the remaining digits
+    while (n > 0) {
+        uint8_t digit = (uint8_t)(n >> k);
+        n &= mask;
+        if (w < NP_DECIMAL_DIGITS) {
+            decimal->digits[w++] = digit;
+        }
+        else if (digit > 0) {
+            decimal->truncated = true;
+        }
+        n *= 10;
+    }
+    decimal->count = w;
+    _np_decimal_trim(decimal);
+}
+
+
+/**
+ * Multiply a big decimal by 2^k
+ * 
+ * @param decimal The big decimal
+ * @param k The shift (negative to divide)
+ */
+static void _np_decimal_shift(np_decimal_t *decimal, int k)
+{
+    if (decimal->count == 0) {
+        return;
+    }
+    for (; k > NP_DECIMAL_MAX_SHIFT; k -= NP_DECIMAL_MAX_SHIFT) {
+        _np_decimal_left_shift(decimal, NP_DECIMAL_MAX_SHIFT);
+    }
+    for (; k < -NP_DECIMAL_MAX_SHIFT; k += NP_DECIMAL_MAX_SHIFT) {
+        _np_decimal_right_shift(decimal, NP_DECIMAL_MAX_SHIFT);
+    }
+    if (k > 0) {
+        _np_decimal_left_shift(decimal, (unsigned int)k);
+    }
+    else if (k < 0) {
+        _np_decimal_right_shift(decimal, (unsigned int)-k);
+    }
+}
+
+
+/**
+ * Round a big decimal to an integer (ties to even)
+ * 
+ * @param decimal The big decimal (less than 2^64)
+ * @return The integer
+ */
+static uint64_t _np_decimal_rounded_integer(const np_decimal_t *decimal)
+{
+    uint64_t n = 0;
+    int i = 0;
+
+    for (; i < decimal->point && i < decimal->count; i++) {
+        n = n * 10 + decimal->digits[i];
+    }
+    for (; i < decimal->point; i++) {
+        n *= 10;
+    }
+
+    int next = decimal->point;
+    if (next >= 0 && next < decimal->count) {
+        if (decimal->digits[next] == 5 && next + 1 == decimal->count) {
+            // Exactly halfway (unless digits were dropped)
+            if (decimal->truncated || (n & 1)) {
+                n++;
+            }
+        }
+        else if (decimal->digits[next] >= 5) {
+            n++;
+        }
+    }
+    return n;
+}
+
+
+/**
+ * Convert a big decimal to the closest double by shifting it until the
+ * 53 bits of the double are its integer part
+ * 
+ * @param decimal The big decimal (changed)
+ * @param underflow Set to true if the decimal is less than DBL_MIN and the
+ *                  double is not exactly the decimal
+ * @return The bits of the (positive) double
+ */
+static uint64_t _np_decimal_to_bits(np_decimal_t *decimal, bool *underflow)
+{
+    // Shifts that keep the leading digit in range, by number of digits
+    static const int shifts[] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+    const int max_shift = 27;
+    int exponent = 0;
+
+    *underflow = false;
+    if (decimal->count == 0) {
+        return 0;
+    }
+    if (decimal->point > 310) {
+        return NP_DOUBLE_INFINITY;
+    }
+    if (decimal->point < -330) {
+        *underflow = true;
+        return 0;
+    }
+
+    // Scale into [0.5, 1)
+    while (decimal->point > 0) {
+        int n = decimal->point < 9 ? shifts[decimal->point] : max_shift;
+        _np_decimal_shift(decimal, -n);
+        exponent += n;
+    }
+    while (decimal->point < 0 || (decimal->point == 0 && decimal->digits[0] < 5)) {
+        int n = -decimal->point < 9 ? shifts[-decimal->point] : max_shift;
+        _np_decimal_shift(decimal, n);
+        exponent -= n;
+    }
+    // Doubles are scaled to [1, 2)
+    exponent--;
+
+    // Subnormals keep the smallest exponent and lose precision instead
+    bool tiny = exponent < -1022;
+    if (tiny) {
+        _np_decimal_shift(decimal, exponent + 1022);
+        exponent = -1022;
+    }
+    if (exponent + 1023 >= 0x7FF) {
+        return NP_DOUBLE_INFINITY;
+    }
+
+    _np_decimal_shift(decimal, NP_DOUBLE_MANTISSA_BITS + 1);
+    *underflow = tiny && (decimal->truncated || decimal->count > decimal->point);
+    uint64_t mantissa = _np_decimal_rounded_integer(decimal);
+    if (mantissa == UINT64_C(2) << NP_DOUBLE_MANTISSA_BITS) {
+        mantissa >>= 1;
+        exponent++;
+        if (exponent + 1023 >= 0x7FF) {
+            return NP_DOUBLE_INFINITY;
+        }
+    }
+    if (!(mantissa & (UINT64_C(1) << NP_DOUBLE_MANTISSA_BITS))) {
+        exponent = -1023;
+    }
+    return (mantissa & ((UINT64_C(1) << NP_DOUBLE_MANTISSA_BITS) - 1)) |
+           ((uint64_t)(exponent + 1023) << NP_DOUBLE_MANTISSA_BITS);
+}
+
+
+/**
+ * Parse a decimal floating-point number: leading whitespace, an optional
+ * sign, digits with an optional '.' and an optional exponent. The number
+ * ends at the first character that does not fit this form.
+ * 
+ * Up to 19 significant digits are converted exactly with double
+ * arithmetic (small exponents) or with the Eisel-Lemire algorithm. If
+ * there are more digits and they are needed to round, the number is
+ * converted with a big decimal instead.
+ * 
+ * @param string The string to parse (may be NULL)
+ * @param len The length of the string (NP_NUL_TERMINATED if NUL-terminated)
+ * @param value Set to the number (0 if there is no number)
+ * @param consumed Set to the number of characters up to the end of the
+ *                 number, 0 if there is no number (may be NULL)
+ * @return NP_SUCCESS, NP_INVALID_STRING, NP_TOO_LARGE or NP_TOO_SMALL (see
+ *         string_to_double()). NP_NON_NUMERIC if there is no decimal number,
+ *         this includes infinity, NaN and hexadecimal numbers
+ */
+static NPError _np_parse_double(const char *string, size_t len, double *value, size_t *consumed)
+{
+    size_t i = 0;
+    bool negative = false;
+
+    *value = 0.0;
+    if (consumed) {
+        *consumed = 0;
+    }
+
+    if (!string) {
+        return NP_INVALID_STRING;
+    }
+    while (i < len && _np_is_space(string[i])) {
+        i++;
+    }
+    if (i == len || string[i] == '\0') {
+        return NP_INVALID_STRING;
+    }
+
+    if (string[i] == '-' || string[i] == '+') {
+        negative = string[i] == '-';
+        i++;
+    }
+    if (len - i > 1 && string[i] == '0' && (string[i + 1] | 0x20) == 'x') {
+        return NP_NON_NUMERIC;
+    }
+
+    // Significand: w * 10^exponent
+    size_t start = i;
+    uint64_t w = 0;
+    int digits = 0;
+    bool truncated = false;
+    int64_t exponent = (int64_t)_np_scan_significand(string, len, &i, &w, &digits, &truncated);
+    bool has_digits = i != start;
+    if (i < len && string[i] == '.') {
+        size_t fraction_start = ++i;
+        size_t dropped = _np_scan_significand(string, len, &i, &w, &digits, &truncated);
+        exponent -= (int64_t)(i - fraction_start - dropped);
+        has_digits |= i != fraction_start;
+    }
+    if (!has_digits) {
+        return NP_NON_NUMERIC;
+    }
+
+    // Exponent (only if there are digits after the e)
+    size_t end = i;
+    int64_t e = 0;
+    if (i < len && (string[i] | 0x20) == 'e') {
+        size_t j = i + 1;
+        bool exponent_negative = false;
+        if (j < len && (string[j] == '-' || string[j] == '+')) {
+            exponent_negative = string[j] == '-';
+            j++;
+        }
+        if (j < len && (unsigned char)(string[j] - '0') < 10) {
+            for (; j < len && (unsigned char)(string[j] - '0') < 10; j++) {
+                if (e < NP_EXPONENT_LIMIT) {
+                    e = e * 10 + (string[j] - '0');
+                }
+            }
+            if (exponent_negative) {
+                e = -e;
+            }
+            exponent += e;
+            i = j;
+        }
+    }
+    if (consumed) {
+        *consumed = i;
+    }
+
+#ifdef NP_FAST_PATH
+    // Both w and 10^exponent are exact doubles, so a single rounding gives
+    // the correct result
+    static const double powers_of_ten[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    if (!truncated && exponent >= -22 && exponent <= 22 &&
+        w <= UINT64_C(1) << (NP_DOUBLE_MANTISSA_BITS + 1)) {
+        double result = (double)w;
+        result = exponent < 0 ? result / powers_of_ten[-exponent] : result * powers_of_ten[exponent];
+        *value = negative ? -result : result;
+        return NP_SUCCESS;
+    }
+#endif
+
+    // If digits were dropped, w and w + 1 round to the same double when the
+    // dropped digits do not matter. A tiny number also needs all the digits
+    // to tell if it is exact (w * 10^q alone never is)
+    bool underflow, tiny_next;
+    uint64_t bits = _np_eisel_lemire(exponent, w, &underflow);
+    if (truncated && (underflow || bits != _np_eisel_lemire(exponent, w + 1, &tiny_next))) {
+        np_decimal_t decimal;
+        _np_decimal_set(&decimal, string + start, end - start, e);
+        bits = _np_decimal_to_bits(&decimal, &underflow);
+    }
+
+    NPError error = NP_SUCCESS;
+    if (bits == NP_DOUBLE_INFINITY) {
+        error = negative ? NP_TOO_SMALL : NP_TOO_LARGE;
+    }
+    else if (underflow) {
+        error = NP_TOO_SMALL;
+    }
+    if (negative) {
+        bits |= NP_DOUBLE_SIGN;
+    }
+    memcpy(value, &bits, sizeof(*value));
+    return error;
+}
+
+
+/**
+ * Check if a string starts with a prefix, ignoring case
+ * 
+ * @param string The string
+ * @param len The length of the string (NP_NUL_TERMINATED if NUL-terminated)
+ * @param prefix The prefix (lower case)
+ * @return true if the string starts with the prefix
+ */
+static bool _np_has_prefix(const char *string, size_t len, const char *prefix)
+{
+    size_t i = 0;
+    for (; prefix[i]; i++) {
+        if (i == len || (string[i] | 0x20) != prefix[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/**
+ * Get a floating-point number from a string with strtod() (for infinity,
+ * NaN and hexadecimal numbers). Anything else is rejected without calling
+ * strtod(), which would accept the locale's decimal point. errno is not
+ * changed.
+ * 
+ * @param value The location to store the parsed number from the input string
+ * @param string The string to parse (not blank)
+ * @param len The length of the string (NP_NUL_TERMINATED if NUL-terminated)
+ * @param consumed See _np_parse_double() (may be NULL)
+ * @return See string_to_double()
+ */
+static NPError _np_strtod(double *value, const char *string, size_t len, size_t *consumed)
+{
+    char buffer[NP_STRTOD_BUFFER];
+    const char *source;
+    size_t skipped = 0;
+    char *endPtr;
+
+    while (skipped < len && _np_is_space(string[skipped])) {
+        skipped++;
+    }
+    size_t i = skipped;
+    if (i < len && (string[i] == '-' || string[i] == '+')) {
+        i++;
+    }
+    if (!_np_has_prefix(string + i, len - i, "inf") &&
+        !_np_has_prefix(string + i, len - i, "nan") &&
+        !_np_has_prefix(string + i, len - i, "0x")) {
+        return NP_NON_NUMERIC;
+    }
+
+    // strtod() needs a NUL-terminated string
+    source = string + skipped;
+    if (len != NP_NUL_TERMINATED) {
+        size_t n = len - skipped < sizeof(buffer) - 1 ? len - skipped : sizeof(buffer) - 1;
+        memcpy(buffer, string + skipped, n);
+        buffer[n] = '\0';
+        source = buffer;
+    }
+
+    int saved_errno = errno;
+    errno = 0;
+    double parsed_value = strtod(source, &endPtr);
+    bool range_error = errno == ERANGE;
+    errno = saved_errno;
+
+    if (endPtr == source) {
+        return NP_NON_NUMERIC;
+    }
+
+    *value = parsed_value;
+    if (consumed) {
+        *consumed = skipped + (size_t)(endPtr - source);
+    }
+    if (range_error)
+    {
+        if (parsed_value == HUGE_VAL) {
+            return NP_TOO_LARGE;
+        }
+
+        // HUGE_VAL has a sign
+        return NP_TOO_SMALL;
+    }
+
+    return NP_SUCCESS;
+}
@@ -7,6 +7,14 @@
  * 2023-03-03: Update formating and add number base
  *             argument to int and uint parsers. 
  *             Also: add np_err2str() function
+ * 2026-10-19: Parse integers without strtol() (single pass, locale
+ *             independent)
+ * 2026-10-19: Parse doubles without strtod() (correctly rounded,
+ *             locale independent)
+ * 2026-10-19: Add strn_to_*() parsers for buffers that are not
+ *             NUL-terminated, and 64 bit integer parsers
+ * 2026-10-19: Add full range int32/uint32/int64/uint64 parsers (status
+ *             only through NPError, errno is not used)
  */
 
 
@@ -20,6 +28,7 @@
 #include <ctype.h>  // isspace()
 #include <math.h>   // HUGE_VAL
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h> // np_perr uses printf
 
 // Remember to add these to np_err2str()
@@ -37,6 +46,17 @@ typedef enum NPError
 NPError string_to_int(int *value, const char *string, int base);
 NPError string_to_uint(int *value, const char *string, int base);
 NPError string_to_double(double *value, const char *string);
+NPError string_to_int32(int32_t *value, const char *string, int base);
+NPError string_to_uint32(uint32_t *value, const char *string, int base);
+NPError string_to_int64(int64_t *value, const char *string, int base);
+NPError string_to_uint64(uint64_t *value, const char *string, int base);
+NPError strn_to_int(int *value, const char *string, size_t len, size_t *consumed, int base);
+NPError strn_to_uint(int *value, const char *string, size_t len, size_t *consumed, int base);
+NPError strn_to_int32(int32_t *value, const char *string, size_t len, size_t *consumed, int base);
+NPError strn_to_uint32(uint32_t *value, const char *string, size_t len, size_t *consumed, int base);
+NPError strn_to_int64(int64_t *value, const char *string, size_t len, size_t *consumed, int base);
+NPError strn_to_uint64(uint64_t *value, const char *string, size_t len, size_t *consumed, int base);
+NPError strn_to_double(double *value, const char *string, size_t len, size_t *consumed);
 bool is_whitespace(const char *string);
 void np_perr(NPError);
 
@@ -0,0 +1,565 @@
+/**
+ * Priority queue (4-ary heap) implementation in c
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-19: Initial creation
+ *
+ * USAGE:
+ * Define PQ_DATA_T as the data type to be stored in the priority queue.
+ * Define PQ_DATA_NAME as the data name for the associated function calls.
+ * Optionally define PQ_COMPARE(a, b) as an expression that is true if
+ * element a belongs closer to the top of the queue than element b. The
+ * default is ((a) < (b)), which makes a min-queue of numbers.
+ * **NOTE**: Do not enclose the first two macros in parens! For example, if
+ *           the data type is char* , define the macros as char* , not (char*)
+ * **NOTE**: Elements are stored by value.
+ *
+ * Unlike the other data structures, the whole priority queue is generated
+ * inline in this header (there is no pqueue.c), so that PQ_COMPARE is
+ * compiled into the sift loops instead of being called through a function
+ * pointer.
+ *
+ * The heap is 4-ary: every node has 4 children, which halves the height
+ * of the tree compared to a binary heap. The root is stored at index
+ * PQ_ROOT (3) of a cache-line aligned array, so the children of node i are
+ * at 4 * (i - 2) ... 4 * (i - 2) + 3 and always start on a multiple of 4.
+ * For elements of up to 16 bytes (with a size that divides 64), all 4
+ * children of a node sit in one cache line.
+ *
+ * Indexed queues (init_indexed()) also support decrease_key(). Each
+ * element pushed with push_handle() is tagged with a handle, which is a
+ * caller-chosen number below max_handles (e.g. a graph vertex number).
+ * The queue keeps track of where each handle's element is in the heap, so
+ * decrease_key() can find it and move it towards the top in O(log n).
+ * Elements pushed with push() in an indexed queue have no handle.
+ */
+
+#include <stddef.h> // size_t
+#include <stdbool.h>
+#include <string.h> // memcpy()
+#include <stdlib.h>
+
+#ifndef PQUEUE_H
+#define PQUEUE_H
+
+#define PQ_CACHE_LINE 64
+#define PQ_ROOT 3
+#define PQ_DEFAULT_SIZE 16
+#define PQ_NO_HANDLE ((size_t)-1)
+
+// Heap index math for the 4-ary layout with the root at PQ_ROOT
+#define PQ_FIRST_CHILD(i) (4 * ((i) - 2))
+#define PQ_PARENT(i) ((i) / 4 + 2)
+
+#define _PQ_GLUE(x, y) x##y
+#define PQ_GLUE(x, y) _PQ_GLUE(x, y)
+
+#endif
+
+// Now on to the "type generic weirdness"
+#if !defined(PQ_DATA_NAME) || !defined(PQ_DATA_T)
+# error "Must define both PQ_DATA_NAME and PQ_DATA_T before including pqueue.h"
+#endif
+
+#ifndef PQ_COMPARE
+# define PQ_COMPARE(a, b) ((a) < (b))
+#endif
+
+#define __PQ_T PQ_GLUE(PQ_DATA_NAME, _pq_t)
+#define __PQ_FN(name) PQ_GLUE(PQ_DATA_NAME, PQ_GLUE(_pq_, name))
+#define __PQ_HELPER(name) PQ_GLUE(_, __PQ_FN(name))
+
+typedef struct __PQ_T {
+    PQ_DATA_T *table;                      // The heap (the root is at PQ_ROOT)
+    size_t number_of_items_in_table;       // Number of items in the queue
+    size_t capacity;                       // Number of items the table has room for
+    size_t *slot_handle;                   // Handle of the element in each slot (NULL if not indexed)
+    size_t *handle_slot;                   // Slot of each handle's element, 0 if not queued (NULL if not indexed)
+    size_t max_handles;                    // Number of handles (0 if not indexed)
+} __PQ_T;
+
+// Helper functions
+
+/**
+ * Allocate a cache-line aligned table with room for capacity elements
+ * (plus the unused slots before the root)
+ *
+ * @param capacity The number of elements
+ * @return The table, NULL on memory allocation failure
+ */
+static inline PQ_DATA_T *__PQ_HELPER(alloc_table)(size_t capacity)
+{
+    if (capacity > ((size_t)-1 - PQ_CACHE_LINE) / sizeof(PQ_DATA_T) - PQ_ROOT) {
+        return NULL;
+    }
+    size_t bytes = sizeof(PQ_DATA_T) * (capacity + PQ_ROOT);
+    bytes = (bytes + PQ_CACHE_LINE - 1) & ~(size_t)(PQ_CACHE_LINE - 1);
+    return aligned_alloc(PQ_CACHE_LINE, bytes);
+}
+
+
+/**
+ * Make room for at least one more element, doubling the capacity
+ *
+ * @param pq The queue to grow
+ * @return false on success, true on failure (memory allocation failure)
+ */
+static inline bool __PQ_HELPER(grow)(__PQ_T *pq)
+{
+    if (pq->capacity > (size_t)-1 / 2) {
+        return true;
+    }
+    size_t capacity = pq->capacity ? pq->capacity * 2 : PQ_DEFAULT_SIZE;
+    PQ_DATA_T *table = __PQ_HELPER(alloc_table)(capacity);
+    if (!table) {
+        return true;
+    }
+    if (pq->slot_handle) {
+        size_t *slot_handle = realloc(pq->slot_handle, sizeof(size_t) * (capacity + PQ_ROOT));
+        if (!slot_handle) {
+            free(table);
+            return true;
+        }
+        pq->slot_handle = slot_handle;
+    }
+    memcpy(table + PQ_ROOT, pq->table + PQ_ROOT, sizeof(PQ_DATA_T) * pq->number_of_items_in_table);
+    free(pq->table);
+    pq->table = table;
+    pq->capacity = capacity;
+    return false;
+}
+
+
+/**
+ * Put an element (and its handle) into a slot
+ *
+ * @param pq The queue
+ * @param slot The slot to fill
+ * @param element The element
+ * @param handle The element's handle (PQ_NO_HANDLE if none)
+ */
+static inline void __PQ_HELPER(place)(__PQ_T *pq, size_t slot, PQ_DATA_T element, size_t handle)
+{
+    pq->table[slot] = element;
+    if (pq->slot_handle) {
+        pq->slot_handle[slot] = handle;
+        if (handle != PQ_NO_HANDLE) {
+            pq->handle_slot[handle] = slot;
+        }
+    }
+}
+
+
+/**
+ * Move an element up from a slot (a hole) until its parent belongs above it
+ *
+ * @param pq The queue
+ * @param slot The slot to start at
+ * @param element The element to place
+ * @param handle The element's handle (PQ_NO_HANDLE if none)
+ */
+static inline void __PQ_HELPER(sift_up)(__PQ_T *pq, size_t slot, PQ_DATA_T element, size_t handle)
+{
+    while (slot > PQ_ROOT) {
+        size_t parent = PQ_PARENT(slot);
+        if (!(PQ_COMPARE(element, pq->table[parent]))) {
+            break;
+        }
+        // Move the parent down into the hole
+        __PQ_HELPER(place)(pq, slot, pq->table[parent], pq->slot_handle ? pq->slot_handle[parent] : PQ_NO_HANDLE);
+        slot = parent;
+    }
+    __PQ_HELPER(place)(pq, slot, element, handle);
+}
+
+
+/**
+ * Move an element down from a slot (a hole) until none of its children
+ * belong above it
+ *
+ * @param pq The queue
+ * @param slot The slot to start at
+ * @param element The element to place
+ * @param handle The element's handle (PQ_NO_HANDLE if none)
+ */
+static inline void __PQ_HELPER(sift_down)(__PQ_T *pq, size_t slot, PQ_DATA_T element, size_t handle)
+{
+    size_t end = PQ_ROOT + pq->number_of_items_in_table;
+    while (true) {
+        size_t child = PQ_FIRST_CHILD(slot);
+        if (child >= end) {
+            break;
+        }
+        size_t last = child + 4 < end ? child + 4 : end;
+        size_t best = child;
+        for (++child; child < last; ++child) {
+            if (PQ_COMPARE(pq->table[child], pq->table[best])) {
+                best = child;
+            }
+        }
+        if (!(PQ_COMPARE(pq->table[best], element))) {
+            break;
+        }
+        // Move the best child up into the hole
+        __PQ_HELPER(place)(pq, slot, pq->table[best], pq->slot_handle ? pq->slot_handle[best] : PQ_NO_HANDLE);
+        slot = best;
+    }
+    __PQ_HELPER(place)(pq, slot, element, handle);
+}
+
+
+/**
+ * Remove the top element, filling the root with the last element
+ *
+ * @param pq The queue (not empty)
+ */
+static inline void __PQ_HELPER(remove_top)(__PQ_T *pq)
+{
+    if (pq->slot_handle && pq->slot_handle[PQ_ROOT] != PQ_NO_HANDLE) {
+        pq->handle_slot[pq->slot_handle[PQ_ROOT]] = 0;
+    }
+    size_t last = PQ_ROOT + --(pq->number_of_items_in_table);
+    if (last != PQ_ROOT) {
+        __PQ_HELPER(sift_down)(pq, PQ_ROOT, pq->table[last], pq->slot_handle ? pq->slot_handle[last] : PQ_NO_HANDLE);
+    }
+}
+
+
+// Function prototypes
+
+/**
+ * Heap-allocate a new priority queue
+ *
+ * @param **pq Pointer to the queue
+ * @param initial_size Number of elements to make room for (0 for PQ_DEFAULT_SIZE)
+ * @return false on success, true on failure (memory allocation failure)
+ */
+static inline bool __PQ_FN(init)(__PQ_T **pq, size_t initial_size)
+{
+    *pq = malloc(sizeof(**pq));
+    if (!*pq) {
+        return true;
+    }
+    (*pq)->capacity = initial_size ? initial_size : PQ_DEFAULT_SIZE;
+    (*pq)->table = __PQ_HELPER(alloc_table)((*pq)->capacity);
+    if (!((*pq)->table)) {
+        free(*pq);
+        *pq = NULL;
+        return true;
+    }
+    (*pq)->number_of_items_in_table = 0;
+    (*pq)->slot_handle = NULL;
+    (*pq)->handle_slot = NULL;
+    (*pq)->max_handles = 0;
+    return false;
+}
+
+
+/**
+ * Heap-allocate a new indexed priority queue, which supports push_handle()
+ * and decrease_key()
+ *
+ * @param **pq Pointer to the queue
+ * @param initial_size Number of elements to make room for (0 for PQ_DEFAULT_SIZE)
+ * @param max_handles Handles may be 0 ... max_handles - 1
+ * @return false on success, true on failure (memory allocation failure)
+ */
+static inline bool __PQ_FN(init_indexed)(__PQ_T **pq, size_t initial_size, size_t max_handles)
+{
+    if (__PQ_FN(init)(pq, initial_size)) {
+        return true;
+    }
+    (*pq)->slot_handle = malloc(sizeof(size_t) * ((*pq)->capacity + PQ_ROOT));
+    (*pq)->handle_slot = calloc(max_handles ? max_handles : 1, sizeof(size_t));
+    if (!((*pq)->slot_handle) || !((*pq)->handle_slot)) {
+        free((*pq)->slot_handle);
+        free((*pq)->handle_slot);
+        free((*pq)->table);
+        free(*pq);
+        *pq = NULL;
+        return true;
+    }
+    (*pq)->max_handles = max_handles;
+    return false;
+}
+
+
+/**
+ * Free a priority queue
+ * @note The *pq is set to NULL
+ *
+ * @param **pq The queue to free
+ */
+static inline void __PQ_FN(destroy)(__PQ_T **pq)
+{
+    if (!pq || !*pq) {
+        return;
+    }
+    free((*pq)->table);
+    free((*pq)->slot_handle);
+    free((*pq)->handle_slot);
+    free(*pq);
+    *pq = NULL;
+}
+
+
+/**
+ * Remove all elements from the queue. The table is kept.
+ *
+ * @param *pq The queue to clear
+ */
+static inline void __PQ_FN(clear)(__PQ_T *pq)
+{
+    if (pq->handle_slot) {
+        memset(pq->handle_slot, 0, sizeof(size_t) * pq->max_handles);
+    }
+    pq->number_of_items_in_table = 0;
+}
+
+
+/**
+ * Returns if there are any elements in the queue
+ *
+ * @param pq The queue to check if empty
+ * @return True if there are 0 elements in the queue,
+ *         False if not empty or if NULL queue
+ */
+static inline bool __PQ_FN(is_empty)(__PQ_T *pq)
+{
+    if (pq != NULL)
+    {
+        return pq->number_of_items_in_table == 0;
+    }
+    return 0;
+}
+
+
+/**
+ * Returns the number of items in the queue
+ *
+ * @param pq The queue to retrieve the number of elements from
+ * @return The number of elements in the queue (0 if queue is NULL)
+ */
+static inline size_t __PQ_FN(get_num_elements)(__PQ_T *pq)
+{
+    if (pq != NULL)
+    {
+        return pq->number_of_items_in_table;
+    }
+    return 0;
+}
+
+
+/**
+ * Get the element at the top of the queue
+ *
+ * @param *pq The queue to look at
+ * @param *element A pointer to the location to store the peek'd value
+ * @return false on success, true on empty queue or null *element pointer
+ */
+static inline bool __PQ_FN(peek)(__PQ_T *pq, PQ_DATA_T *element)
+{
+    if (!element || __PQ_FN(is_empty)(pq)) {
+        return true;
+    }
+    *element = pq->table[PQ_ROOT];
+    return false;
+}
+
+
+/**
+ * Add an element to the queue
+ *
+ * @param *pq The queue to add the element to
+ * @param element The element
+ * @return false on success, true on failure (memory allocation failure)
+ */
+static inline bool __PQ_FN(push)(__PQ_T *pq, PQ_DATA_T element)
+{
+    if (pq->number_of_items_in_table == pq->capacity && __PQ_HELPER(grow)(pq)) {
+        return true;
+    }
+    __PQ_HELPER(sift_up)(pq, PQ_ROOT + (pq->number_of_items_in_table)++, element, PQ_NO_HANDLE);
+    return false;
+}
+
+
+/**
+ * Remove the element at the top of the queue and return its value
+ *
+ * @param *pq The queue to remove the element from
+ * @param *element A pointer to the location to store the pop'd value
+ * @return false on success, true on empty queue or null *element pointer
+ */
+static inline bool __PQ_FN(pop)(__PQ_T *pq, PQ_DATA_T *element)
+{
+    if (__PQ_FN(peek)(pq, element)) {
+        return true;
+    }
+    __PQ_HELPER(remove_top)(pq);
+    return false;
+}
+
+
+/**
+ * Remove the element at the top of the queue and add a new element, with
+ * a single pass down the heap (faster than pop() followed by push())
+ *
+ * @param *pq The queue
+ * @param element The element to add
+ * @param *top A pointer to the location to store the removed top element
+ *             (may be NULL)
+ * @return false on success, true on empty queue (nothing is added)
+ */
+static inline bool __PQ_FN(replace_top)(__PQ_T *pq, PQ_DATA_T element, PQ_DATA_T *top)
+{
+    if (__PQ_FN(is_empty)(pq)) {
+        return true;
+    }
+    if (top) {
+        *top = pq->table[PQ_ROOT];
+    }
+    if (pq->slot_handle && pq->slot_handle[PQ_ROOT] != PQ_NO_HANDLE) {
+        pq->handle_slot[pq->slot_handle[PQ_ROOT]] = 0;
+    }
+    __PQ_HELPER(sift_down)(pq, PQ_ROOT, element, PQ_NO_HANDLE);
+    return false;
+}
+
+
+/**
+ * Replace the contents of the queue with n elements, building the heap
+ * bottom-up in O(n) (faster than n push()es)
+ *
+ * @param *pq The queue
+ * @param *elements The elements to add (not modified)
+ * @param n The number of elements
+ * @return false on success, true on failure (memory allocation failure
+ *         or null *elements pointer). On failure the queue is unchanged.
+ */
+static inline bool __PQ_FN(heapify)(__PQ_T *pq, const PQ_DATA_T *elements, size_t n)
+{
+    if (!elements && n) {
+        return true;
+    }
+    if (n > pq->capacity) {
+        PQ_DATA_T *table = __PQ_HELPER(alloc_table)(n);
+        if (!table) {
+            return true;
+        }
+        if (pq->slot_handle) {
+            size_t *slot_handle = realloc(pq->slot_handle, sizeof(size_t) * (n + PQ_ROOT));
+            if (!slot_handle) {
+                free(table);
+                return true;
+            }
+            pq->slot_handle = slot_handle;
+        }
+        free(pq->table);
+        pq->table = table;
+        pq->capacity = n;
+    }
+
+    __PQ_FN(clear)(pq);
+    if (n) {
+        memcpy(pq->table + PQ_ROOT, elements, sizeof(PQ_DATA_T) * n);
+    }
+    if (pq->slot_handle) {
+        for (size_t i = 0; i < n; i++) {
+            pq->slot_handle[PQ_ROOT + i] = PQ_NO_HANDLE;
+        }
+    }
+    pq->number_of_items_in_table = n;
+
+    // Sift down every node that has children, from the last one up
+    for (size_t slot = n ? PQ_PARENT(PQ_ROOT + n - 1) + 1 : PQ_ROOT; slot-- > PQ_ROOT; ) {
+        __PQ_HELPER(sift_down)(pq, slot, pq->table[slot], PQ_NO_HANDLE);
+    }
+    return false;
+}
+
+
+/**
+ * Check if an element with a handle is in an indexed queue
+ *
+ * @param *pq The queue
+ * @param handle The handle to look for
+ * @return true if the handle's element is queued, false if not (or if
+ *         the queue is not indexed)
+ */
+static inline bool __PQ_FN(contains)(__PQ_T *pq, size_t handle)
+{
+    return pq->handle_slot && handle < pq->max_handles && pq->handle_slot[handle] != 0;
+}
+
+
+/**
+ * Add an element with a handle to an indexed queue
+ *
+ * @param *pq The queue to add the element to
+ * @param handle The element's handle (below max_handles, not queued)
+ * @param element The element
+ * @return false on success, true on failure (memory allocation failure,
+ *         queue not indexed, handle out of range or already queued)
+ */
+static inline bool __PQ_FN(push_handle)(__PQ_T *pq, size_t handle, PQ_DATA_T element)
+{
+    if (!pq->handle_slot || handle >= pq->max_handles || pq->handle_slot[handle] != 0) {
+        return true;
+    }
+    if (pq->number_of_items_in_table == pq->capacity && __PQ_HELPER(grow)(pq)) {
+        return true;
+    }
+    __PQ_HELPER(sift_up)(pq, PQ_ROOT + (pq->number_of_items_in_table)++, element, handle);
+    return false;
+}
+
+
+/**
+ * Get the handle of the element at the top of an indexed queue
+ *
+ * @param *pq The queue to look at
+ * @return The handle, PQ_NO_HANDLE on empty queue, if the queue is not
+ *         indexed or if the top element was added without a handle
+ */
+static inline size_t __PQ_FN(top_handle)(__PQ_T *pq)
+{
+    if (!pq->slot_handle || __PQ_FN(is_empty)(pq)) {
+        return PQ_NO_HANDLE;
+    }
+    return pq->slot_handle[PQ_ROOT];
+}
+
+
+/**
+ * Replace the element of a handle with one that belongs closer to the top
+ * of the queue (e.g. a smaller distance in a min-queue) and move it up
+ *
+ * @param *pq The queue
+ * @param handle The handle of the element to replace
+ * @param element The new element
+ * @return false on success, true if the handle is not queued or if the
+ *         new element belongs further from the top than the old one
+ *         (nothing is changed)
+ */
+static inline bool __PQ_FN(decrease_key)(__PQ_T *pq, size_t handle, PQ_DATA_T element)
+{
+    if (!__PQ_FN(contains)(pq, handle)) {
+        return true;
+    }
+    size_t slot = pq->handle_slot[handle];
+    if (PQ_COMPARE(pq->table[slot], element)) {
+        return true;
+    }
+    __PQ_HELPER(sift_up)(pq, slot, element, handle);
+    return false;
+}
+
+#undef PQ_DATA_T
+#undef PQ_DATA_NAME
+#undef PQ_COMPARE
+#undef __PQ_T
+#undef __PQ_FN
+#undef __PQ_HELPER
+
@@ -0,0 +1,354 @@
+/**
+ * Throughput benchmark for the concurrent queues
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-19: Initial creation
+ *
+ * USAGE:
+ *     gcc -std=c11 -O2 -pthread queue-bench.c queue.c -o queue-bench
+ *     ./queue-bench [items per run] [capacity]
+ *
+ * Moves a number of items from producer threads to consumer threads
+ * through one queue, for every combination of 1, 2, 4, ... 64 producers
+ * and consumers, and prints the throughput of each run in operations per
+ * second (one enqueue or one dequeue is an operation, so each item is two
+ * operations). The queues compared are:
+ *
+ *   mpmc-blocking  MPMC queue created with blocking set, using
+ *                  enqueue_wait() and dequeue_wait() (futex sleep on Linux)
+ *   mpmc-try       MPMC queue without blocking, using the non-blocking
+ *                  enqueue() and dequeue() and sched_yield() on failure
+ *   spsc           SPSC queue (1 producer and 1 consumer only), using
+ *                  enqueue() and dequeue() and sched_yield() on failure
+ *
+ * Once the producers are done, one end marker per consumer is enqueued
+ * to stop the consumers. The consumers check that every item arrived. The
+ * time measured is from the first thread leaving the start gate to the
+ * last thread finishing.
+ * **NOTE**: Requires POSIX threads and clock_gettime()
+ */
+
+#ifndef _DEFAULT_SOURCE
+# define _DEFAULT_SOURCE // clock_gettime() in strict C modes
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#define QUEUE_DATA_T long
+#define QUEUE_DATA_NAME long
+#include "queue.h"
+
+#define BENCH_DEFAULT_ITEMS (1L << 20)
+#define BENCH_DEFAULT_CAPACITY 1024
+#define BENCH_MAX_THREADS 64
+#define BENCH_END_MARKER (-1L)
+
+typedef enum bench_queue_t {
+    BENCH_MPMC_BLOCKING,
+    BENCH_MPMC_TRY,
+    BENCH_SPSC
+} bench_queue_t;
+
+typedef struct bench_thread_t {
+    pthread_t thread;
+    bench_queue_t type;
+    long items;                            // Items to enqueue (producers only)
+    long received;                         // Items dequeued (consumers only)
+    long long sum;                         // Sum of the items dequeued (consumers only)
+    double start;                          // When the thread left the start gate
+    double end;                            // When the thread finished
+} bench_thread_t;
+
+typedef enum bench_start_t {
+    BENCH_WAIT,                            // Threads are still being created
+    BENCH_GO,
+    BENCH_ABORT                            // Creating a thread failed
+} bench_start_t;
+
+// Holds the threads until all of them have been created
+static pthread_mutex_t start_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t start_cond = PTHREAD_COND_INITIALIZER;
+static bench_start_t start_state;
+
+static long_mpmc_queue_t *mpmc_queue;
+static long_spsc_queue_t *spsc_queue;
+
+// Helper functions
+static void _enqueue(bench_queue_t type, long item);
+static long _dequeue(bench_queue_t type);
+static bool _start_wait(void);
+static void _start_release(bench_start_t state);
+static void *_producer(void *arg);
+static void *_consumer(void *arg);
+static double _bench_run(bench_queue_t type, int producers, int consumers, long items, size_t capacity);
+static double _now(void);
+
+
+int main(int argc, char **argv)
+{
+    static const char *names[] = {"mpmc-blocking", "mpmc-try", "spsc"};
+    long items = argc > 1 ? atol(argv[1]) : BENCH_DEFAULT_ITEMS;
+    long capacity = argc > 2 ? atol(argv[2]) : BENCH_DEFAULT_CAPACITY;
+    if (items <= 0 || capacity <= 0) {
+        fprintf(stderr, "usage: %s [items per run] [capacity]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%-14s %9s %9s %12s\n", "queue", "producers", "consumers", "Mops/s");
+    for (int type = BENCH_MPMC_BLOCKING; type <= BENCH_SPSC; type++) {
+        int max_threads = type == BENCH_SPSC ? 1 : BENCH_MAX_THREADS;
+        for (int producers = 1; producers <= max_threads; producers *= 2) {
+            for (int consumers = 1; consumers <= max_threads; consumers *= 2) {
+                double seconds = _bench_run((bench_queue_t)type, producers, consumers, items, (size_t)capacity);
+                if (seconds < 0) {
+                    fprintf(stderr, "%s: failed with %d producers and %d consumers\n",
+                            names[type], producers, consumers);
+                    return 1;
+                }
+                // Every producer enqueues the same number of items
+                double ops = 2.0 * (double)(items / producers * producers);
+                printf("%-14s %9d %9d %12.2f\n", names[type], producers, consumers, ops / seconds / 1e6);
+            }
+        }
+    }
+    return 0;
+}
+
+
+/**
+ * Run one benchmark
+ *
+ * @param type The queue to use
+ * @param producers The number of producer threads
+ * @param consumers The number of consumer threads
+ * @param items The number of items (rounded down to a multiple of producers)
+ * @param capacity The capacity of the queue
+ * @return The wall clock time in seconds, negative on failure (memory
+ *         allocation failure, thread creation failure or lost items)
+ */
+static double _bench_run(bench_queue_t type, int producers, int consumers, long items, size_t capacity)
+{
+    bench_thread_t workers[2 * BENCH_MAX_THREADS];
+    int threads = producers + consumers;
+    long per_producer = items / producers;
+    bool failed = false;
+    int created;
+
+    if (type == BENCH_SPSC ? long_spsc_queue_init(&spsc_queue, capacity)
+                           : long_mpmc_queue_init(&mpmc_queue, capacity, type == BENCH_MPMC_BLOCKING)) {
+        return -1.0;
+    }
+    start_state = BENCH_WAIT;
+    for (created = 0; created < threads; created++) {
+        workers[created].type = type;
+        workers[created].items = per_producer;
+        workers[created].received = 0;
+        workers[created].sum = 0;
+        workers[created].start = 0.0;
+        workers[created].end = 0.0;
+        if (pthread_create(&workers[created].thread, NULL, created < producers ? _producer : _consumer,
+                           &workers[created])) {
+            failed = true;
+            break;
+        }
+    }
+    // Let the threads run, or make the ones already created exit
+    _start_release(failed ? BENCH_ABORT : BENCH_GO);
+
+    // The consumers only stop at an end marker, so send them once all
+    // items are in the queue
+    for (int i = 0; i < producers && i < created; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    if (!failed) {
+        for (int i = 0; i < consumers; i++) {
+            _enqueue(type, BENCH_END_MARKER);
+        }
+    }
+
+    double start = 0.0, end = 0.0;
+    long received = 0;
+    long long sum = 0;
+    for (int i = 0; i < created; i++) {
+        if (i >= producers) {
+            pthread_join(workers[i].thread, NULL);
+            received += workers[i].received;
+            sum += workers[i].sum;
+        }
+        if (i == 0 || workers[i].start < start) {
+            start = workers[i].start;
+        }
+        if (workers[i].end > end) {
+            end = workers[i].end;
+        }
+    }
+
+    if (type == BENCH_SPSC) {
+        long_spsc_queue_destroy(&spsc_queue);
+    }
+    else {
+        long_mpmc_queue_destroy(&mpmc_queue);
+    }
+
+    // Each producer sends 0 ... per_producer - 1
+    long long expected = (long long)producers * per_producer * (per_producer - 1) / 2;
+    if (failed || received != per_producer * producers || sum != expected) {
+        return -1.0;
+    }
+    return end - start;
+}
+
+
+/**
+ * Wait until _start_release() is called
+ *
+ * @return false to run, true if the run was aborted
+ */
+static bool _start_wait(void)
+{
+    pthread_mutex_lock(&start_lock);
+    while (start_state == BENCH_WAIT) {
+        pthread_cond_wait(&start_cond, &start_lock);
+    }
+    bool aborted = (start_state == BENCH_ABORT);
+    pthread_mutex_unlock(&start_lock);
+    return aborted;
+}
+
+
+/**
+ * Release the threads waiting in _start_wait()
+ *
+ * @param state BENCH_GO to run, BENCH_ABORT to make them exit
+ */
+static void _start_release(bench_start_t state)
+{
+    pthread_mutex_lock(&start_lock);
+    start_state = state;
+    pthread_cond_broadcast(&start_cond);
+    pthread_mutex_unlock(&start_lock);
+}
+
+
+/**
+ * Producer thread: wait for the others to be created, then enqueue
+ * 0 ... items - 1
+ *
+ * @param arg The thread's bench_thread_t
+ * @return NULL
+ */
+static void *_producer(void *arg)
+{
+    bench_thread_t *worker = arg;
+
+    if (_start_wait()) {
+        return NULL;
+    }
+    worker->start = _now();
+    for (long i = 0; i < worker->items; i++) {
+        _enqueue(worker->type, i);
+    }
+    worker->end = _now();
+    return NULL;
+}
+
+
+/**
+ * Consumer thread: wait for the others to be created, then dequeue
+ * items until an end marker arrives
+ *
+ * @param arg The thread's bench_thread_t
+ * @return NULL
+ */
+static void *_consumer(void *arg)
+{
+    bench_thread_t *worker = arg;
+    long item;
+
+    if (_start_wait()) {
+        return NULL;
+    }
+    worker->start = _now();
+    while ((item = _dequeue(worker->type)) != BENCH_END_MARKER) {
+        worker->received++;
+        worker->sum += item;
+    }
+    worker->end = _now();
+    return NULL;
+}
+
+
+/**
+ * Enqueue an item, waiting until there is room
+ *
+ * @param type The queue to use
+ * @param item The item
+ */
+static void _enqueue(bench_queue_t type, long item)
+{
+    switch (type) {
+    case BENCH_MPMC_BLOCKING:
+        long_mpmc_queue_enqueue_wait(mpmc_queue, item);
+        break;
+
+    case BENCH_MPMC_TRY:
+        while (long_mpmc_queue_enqueue(mpmc_queue, item)) {
+            sched_yield();
+        }
+        break;
+
+    case BENCH_SPSC:
+        while (long_spsc_queue_enqueue(spsc_queue, item)) {
+            sched_yield();
+        }
+        break;
+    }
+}
+
+
+/**
+ * Dequeue an item, waiting until there is one
+ *
+ * @param type The queue to use
+ * @return The item
+ */
+static long _dequeue(bench_queue_t type)
+{
+    long item = BENCH_END_MARKER;
+
+    switch (type) {
+    case BENCH_MPMC_BLOCKING:
+        long_mpmc_queue_dequeue_wait(mpmc_queue, &item);
+        break;
+
+    case BENCH_MPMC_TRY:
+        while (long_mpmc_queue_dequeue(mpmc_queue, &item)) {
+            sched_yield();
+        }
+        break;
+
+    case BENCH_SPSC:
+        while (long_spsc_queue_dequeue(spsc_queue, &item)) {
+            sched_yield();
+        }
+        break;
+    }
+    return item;
+}
+
+
+/**
+ * Read the monotonic clock
+ *
+ * @return The time in seconds
+ */
+static double _now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
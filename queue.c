@@ -0,0 +1,734 @@
+/**
+ * Bounded concurrent queues in c
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-18: Initial creation (single-producer/single-consumer queue)
+ * 2026-10-19: Add multi-producer/multi-consumer queue
+ *
+ * USAGE: see queue.h
+ *
+ * The MPMC queue is based on Dmitry Vyukov's "Bounded MPMC queue".
+ */
+
+#if defined(__linux__)
+# ifndef _DEFAULT_SOURCE
+#  define _DEFAULT_SOURCE // syscall() in strict C modes
+# endif
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+# define QUEUE_HAVE_FUTEX
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+# include <sched.h> // sched_yield()
+# define QUEUE_HAVE_YIELD
+#endif
+
+#include <stdlib.h>
+#include <string.h> // memcpy()
+
+#define __QUEUE_QUEUE_C
+#include "queue.h"
+#undef __QUEUE_QUEUE_C
+
+// Helper functions
+static inline char *_spsc_queue_slot(spsc_queue_t *queue, size_t element_size, size_t index);
+static void _spsc_queue_copy_in(spsc_queue_t *queue, size_t element_size, size_t index, const char *elements, size_t n);
+static void _spsc_queue_copy_out(spsc_queue_t *queue, size_t element_size, size_t index, char *elements, size_t n);
+static inline size_t _mpmc_queue_align(size_t bytes);
+static inline _Atomic size_t *_mpmc_queue_sequence(mpmc_queue_t *queue, size_t index);
+static inline char *_mpmc_queue_data(mpmc_queue_t *queue, size_t index);
+static inline void _mpmc_queue_yield(void);
+#ifdef QUEUE_HAVE_FUTEX
+static void _mpmc_queue_wake(_Atomic unsigned int *event, _Atomic unsigned int *waiters);
+static void _mpmc_queue_sleep(_Atomic unsigned int *event, unsigned int seen);
+#endif
+
+
+/**
+ * Heap-allocate a new single-producer/single-consumer queue
+ *
+ * @param **queue Pointer to the queue
+ * @param element_size [internal use] Size of element stored in queue
+ * @param capacity Number of elements the queue can hold (rounded up
+ *                 to a power of 2 of at least QUEUE_MIN_SIZE)
+ * @return false on success, true on failure (memory allocation failure)
+ */
+bool __spsc_queue_init(spsc_queue_t **queue, size_t element_size, size_t capacity)
+{
+    size_t size = QUEUE_MIN_SIZE;
+    while (size < capacity) {
+        if (size > (size_t)-1 / 2) {
+            return true;
+        }
+        size *= 2;
+    }
+    if (size > (size_t)-1 / element_size) {
+        return true;
+    }
+
+    *queue = aligned_alloc(QUEUE_CACHE_LINE, sizeof(**queue));
+    if (!*queue) {
+        return true;
+    }
+    (*queue)->table = malloc(element_size * size);
+    if (!((*queue)->table)) {
+        free(*queue);
+        *queue = NULL;
+        return true;
+    }
+    atomic_init(&((*queue)->head), 0);
+    atomic_init(&((*queue)->tail), 0);
+    (*queue)->tail_cache = 0;
+    (*queue)->head_cache = 0;
+    (*queue)->mask = size - 1;
+    return false;
+}
+
+
+/**
+ * Free a single-producer/single-consumer queue
+ * @note Must not be called while other threads use the queue
+ * @note The *queue is set to NULL
+ *
+ * @param **queue The queue to free
+ */
+void __spsc_queue_destroy(spsc_queue_t **queue)
+{
+    if (!queue || !*queue) {
+        return;
+    }
+    free((*queue)->table);
+    free(*queue);
+    *queue = NULL;
+}
+
+
+/**
+ * Add an item to the tail of the queue
+ * @note Producer thread only
+ *
+ * @param *queue The queue to add the item to
+ * @param element_size [internal use] The size of an element stored in the queue
+ * @param *element The data to add to the queue
+ * @return false on success, true on full queue
+ */
+bool __spsc_queue_enqueue(spsc_queue_t *queue, size_t element_size, const void *element)
+{
+    size_t tail = atomic_load_explicit(&(queue->tail), memory_order_relaxed);
+
+    if (tail - queue->head_cache > queue->mask) {
+        queue->head_cache = atomic_load_explicit(&(queue->head), memory_order_acquire);
+        if (tail - queue->head_cache > queue->mask) {
+            return true;
+        }
+    }
+    memcpy(_spsc_queue_slot(queue, element_size, tail), element, element_size);
+
+    // Publish the element along with the new tail
+    atomic_store_explicit(&(queue->tail), tail + 1, memory_order_release);
+    return false;
+}
+
+
+/**
+ * Add up to n items to the tail of the queue, as many as fit
+ * @note Producer thread only
+ *
+ * @param *queue The queue to add the items to
+ * @param element_size [internal use] The size of an element stored in the queue
+ * @param *elements The array of items to add, first item first
+ * @param n The number of items in *elements
+ * @return The number of items added (the first ones in *elements)
+ */
+size_t __spsc_queue_enqueue_n(spsc_queue_t *queue, size_t element_size, const void *elements, size_t n)
+{
+    size_t tail = atomic_load_explicit(&(queue->tail), memory_order_relaxed);
+    size_t space = queue->mask + 1 - (tail - queue->head_cache);
+
+    if (space < n) {
+        queue->head_cache = atomic_load_explicit(&(queue->head), memory_order_acquire);
+        space = queue->mask + 1 - (tail - queue->head_cache);
+        if (space < n) {
+            n = space;
+        }
+    }
+    if (n) {
+        _spsc_queue_copy_in(queue, element_size, tail, elements, n);
+        atomic_store_explicit(&(queue->tail), tail + n, memory_order_release);
+    }
+    return n;
+}
+
+
+/**
+ * Remove the item at the head of the queue and return its value
+ * @note Consumer thread only
+ *
+ * @param *queue The queue to remove the item from
+ * @param element_size [internal use] The size of an element stored in the queue
+ * @param *element A pointer to the location to store the dequeue'd value
+ * @return false on success, true on empty queue or null *element pointer
+ */
+bool __spsc_queue_dequeue(spsc_queue_t *queue, size_t element_size, void *element)
+{
+    if (!element) {
+        return true;
+    }
+
+    size_t head = atomic_load_explicit(&(queue->head), memory_order_relaxed);
+
+    if (head == queue->tail_cache) {
+        queue->tail_cache = atomic_load_explicit(&(queue->tail), memory_order_acquire);
+        if (head == queue->tail_cache) {
+            return true;
+        }
+    }
+    memcpy(element, _spsc_queue_slot(queue, element_size, head), element_size);
+
+    // Hand the slot back to the producer
+    atomic_store_explicit(&(queue->head), head + 1, memory_order_release);
+    return false;
+}
+
+
+/**
+ * Remove up to n items from the head of the queue, as many as are queued
+ * @note Consumer thread only
+ *
+ * @param *queue The queue to remove the items from
+ * @param element_size [internal use] The size of an element stored in the queue
+ * @param *elements The array to store the items in, first item first
+ *                  (room for n items)
+ * @param n The maximum number of items to remove
+ * @return The number of items removed (0 on empty queue or null *elements pointer)
+ */
+size_t __spsc_queue_dequeue_n(spsc_queue_t *queue, size_t element_size, void *elements, size_t n)
+{
+    if (!elements) {
+        return 0;
+    }
+
+    size_t head = atomic_load_explicit(&(queue->head), memory_order_relaxed);
+    size_t available = queue->tail_cache - head;
+
+    if (available < n) {
+        queue->tail_cache = atomic_load_explicit(&(queue->tail), memory_order_acquire);
+        available = queue->tail_cache - head;
+        if (available < n) {
+            n = available;
+        }
+    }
+    if (n) {
+        _spsc_queue_copy_out(queue, element_size, head, elements, n);
+        atomic_store_explicit(&(queue->head), head + n, memory_order_release);
+    }
+    return n;
+}
+
+
+/**
+ * Returns if there are any elements in the queue
+ * @note With other threads using the queue, the result may be
+ *       outdated by the time it is returned
+ *
+ * @param queue The queue to check if empty
+ * @return True if there are 0 elements in the queue,
+ *         False if not empty or if NULL queue
+ */
+bool __spsc_queue_is_empty(spsc_queue_t *queue)
+{
+    if (queue != NULL)
+    {
+        return __spsc_queue_get_num_elements(queue) == 0;
+    }
+    return 0;
+}
+
+
+/**
+ * Returns the number of items in the queue
+ * @note With other threads using the queue, the result may be
+ *       outdated by the time it is returned
+ *
+ * @param queue The queue to retrieve the number of elements from
+ * @return The number of elements in the queue (0 if queue is NULL)
+ */
+size_t __spsc_queue_get_num_elements(spsc_queue_t *queue)
+{
+    if (queue != NULL)
+    {
+        size_t head = atomic_load_explicit(&(queue->head), memory_order_acquire);
+        size_t tail = atomic_load_explicit(&(queue->tail), memory_order_acquire);
+        return tail - head;
+    }
+    return 0;
+}
+
+
+/**
+ * Returns the maximum number of items the queue can hold
+ *
+ * @param queue The queue to check
+ * @return The capacity of the queue (0 if queue is NULL)
+ */
+size_t __spsc_queue_get_capacity(spsc_queue_t *queue)
+{
+    if (queue != NULL)
+    {
+        return queue->mask + 1;
+    }
+    return 0;
+}
+
+
+/**
+ * Heap-allocate a new multi-producer/multi-consumer queue
+ *
+ * @param **queue Pointer to the queue
+ * @param element_size [internal use] Size of element stored in queue
+ * @param capacity Number of elements the queue can hold (rounded up
+ *                 to a power of 2 of at least QUEUE_MIN_SIZE)
+ * @param blocking Whether enqueue_wait() and dequeue_wait() may sleep
+ *                 (only has an effect on Linux)
+ * @return false on success, true on failure (memory allocation failure)
+ */
+bool __mpmc_queue_init(mpmc_queue_t **queue, size_t element_size, size_t capacity, bool blocking)
+{
+    size_t size = QUEUE_MIN_SIZE;
+    while (size < capacity) {
+        if (size > (size_t)-1 / 2) {
+            return true;
+        }
+        size *= 2;
+    }
+    size_t data_offset = _mpmc_queue_align(sizeof(_Atomic size_t));
+    if (element_size > (size_t)-1 - 2 * data_offset) {
+        return true;
+    }
+    size_t slot_size = _mpmc_queue_align(data_offset + element_size);
+    if (size > (size_t)-1 / slot_size) {
+        return true;
+    }
+
+    *queue = aligned_alloc(QUEUE_CACHE_LINE, sizeof(**queue));
+    if (!*queue) {
+        return true;
+    }
+    (*queue)->table = malloc(slot_size * size);
+    if (!((*queue)->table)) {
+        free(*queue);
+        *queue = NULL;
+        return true;
+    }
+    (*queue)->mask = size - 1;
+    (*queue)->slot_size = slot_size;
+    (*queue)->blocking = blocking;
+    for (size_t i = 0; i < size; i++) {
+        atomic_init(_mpmc_queue_sequence(*queue, i), i);
+    }
+    atomic_init(&((*queue)->enqueue_pos), 0);
+    atomic_init(&((*queue)->dequeue_pos), 0);
+    atomic_init(&((*queue)->not_empty), 0);
+    atomic_init(&((*queue)->not_full), 0);
+    atomic_init(&((*queue)->empty_waiters), 0);
+    atomic_init(&((*queue)->full_waiters), 0);
+    return false;
+}
+
+
+/**
+ * Free a multi-producer/multi-consumer queue
+ * @note Must not be called while other threads use the queue
+ * @note The *queue is set to NULL
+ *
+ * @param **queue The queue to free
+ */
+void __mpmc_queue_destroy(mpmc_queue_t **queue)
+{
+    if (!queue || !*queue) {
+        return;
+    }
+    free((*queue)->table);
+    free(*queue);
+    *queue = NULL;
+}
+
+
+/**
+ * Add an item to the tail of the queue without waiting
+ *
+ * @param *queue The queue to add the item to
+ * @param element_size [internal use] The size of an element stored in the queue
+ * @param *element The data to add to the queue
+ * @return false on success, true on full queue
+ */
+bool __mpmc_queue_enqueue(mpmc_queue_t *queue, size_t element_size, const void *element)
+{
+    size_t pos = atomic_load_explicit(&(queue->enqueue_pos), memory_order_relaxed);
+    while (true) {
+        size_t sequence = atomic_load_explicit(_mpmc_queue_sequence(queue, pos), memory_order_acquire);
+        ptrdiff_t lap = (ptrdiff_t)(sequence - pos);
+
+        if (lap == 0) {
+            // The slot is free on this lap: try to claim it
+            if (atomic_compare_exchange_weak_explicit(&(queue->enqueue_pos), &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (lap < 0) {
+            // The slot still holds the element from the previous lap
+            return true;
+        }
+        else {
+            // Another producer claimed the slot first
+            pos = atomic_load_explicit(&(queue->enqueue_pos), memory_order_relaxed);
+        }
+    }
+
+    memcpy(_mpmc_queue_data(queue, pos), element, element_size);
+    atomic_store_explicit(_mpmc_queue_sequence(queue, pos), pos + 1, memory_order_release);
+
+#ifdef QUEUE_HAVE_FUTEX
+    if (queue->blocking) {
+        _mpmc_queue_wake(&(queue->not_empty), &(queue->empty_waiters));
+    }
+#endif
+    return false;
+}
+
+
+/**
+ * Add an item to the tail of the queue, waiting for room if the queue is full
+ *
+ * @param *queue The queue to add the item to
+ * @param element_size [internal use] The size of an element stored in the queue
+ * @param *element The data to add to the queue
+ * @return false on success, true on null *element pointer
+ */
+bool __mpmc_queue_enqueue_wait(mpmc_queue_t *queue, size_t element_size, const void *element)
+{
+    if (!element) {
+        return true;
+    }
+
+    unsigned int spins = 0;
+    while (__mpmc_queue_enqueue(queue, element_size, element)) {
+        if (++spins < QUEUE_SPIN_COUNT) {
+            continue;
+        }
+#ifdef QUEUE_HAVE_FUTEX
+        if (queue->blocking) {
+            // Register as a waiter before the last try, so that a consumer
+            // either sees the waiter or frees up the slot this try gets
+            unsigned int seen = atomic_load(&(queue->not_full));
+            atomic_fetch_add(&(queue->full_waiters), 1);
+            atomic_thread_fence(memory_order_seq_cst);
+            bool full = __mpmc_queue_enqueue(queue, element_size, element);
+            if (full) {
+                _mpmc_queue_sleep(&(queue->not_full), seen);
+            }
+            atomic_fetch_sub(&(queue->full_waiters), 1);
+            if (!full) {
+                return false;
+            }
+            continue;
+        }
+#endif
+        _mpmc_queue_yield();
+    }
+    return false;
+}
+
+
+/**
+ * Remove the item at the head of the queue without waiting
+ *
+ * @param *queue The queue to remove the item from
+ * @param element_size [internal use] The size of an element stored in the queue
+ * @param *element A pointer to the location to store the dequeue'd value
+ * @return false on success, true on empty queue or null *element pointer
+ */
+bool __mpmc_queue_dequeue(mpmc_queue_t *queue, size_t element_size, void *element)
+{
+    if (!element) {
+        return true;
+    }
+
+    size_t pos = atomic_load_explicit(&(queue->dequeue_pos), memory_order_relaxed);
+    while (true) {
+        size_t sequence = atomic_load_explicit(_mpmc_queue_sequence(queue, pos), memory_order_acquire);
+        ptrdiff_t lap = (ptrdiff_t)(sequence - (pos + 1));
+
+        if (lap == 0) {
+            // The slot holds an element for this lap: try to claim it
+            if (atomic_compare_exchange_weak_explicit(&(queue->dequeue_pos), &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (lap < 0) {
+            // The slot has not been written on this lap yet
+            return true;
+        }
+        else {
+            // Another consumer claimed the slot first
+            pos = atomic_load_explicit(&(queue->dequeue_pos), memory_order_relaxed);
+        }
+    }
+
+    memcpy(element, _mpmc_queue_data(queue, pos), element_size);
+
+    // Free the slot for the next lap
+    atomic_store_explicit(_mpmc_queue_sequence(queue, pos), pos + queue->mask + 1, memory_order_release);
+
+#ifdef QUEUE_HAVE_FUTEX
+    if (queue->blocking) {
+        _mpmc_queue_wake(&(queue->not_full), &(queue->full_waiters));
+    }
+#endif
+    return false;
+}
+
+
+/**
+ * Remove the item at the head of the queue, waiting for one if the queue
+ * is empty
+ *
+ * @param *queue The queue to remove the item from
+ * @param element_size [internal use] The size of an element stored in the queue
+ * @param *element A pointer to the location to store the dequeue'd value
+ * @return false on success, true on null *element pointer
+ */
+bool __mpmc_queue_dequeue_wait(mpmc_queue_t *queue, size_t element_size, void *element)
+{
+    if (!element) {
+        return true;
+    }
+
+    unsigned int spins = 0;
+    while (__mpmc_queue_dequeue(queue, element_size, element)) {
+        if (++spins < QUEUE_SPIN_COUNT) {
+            continue;
+        }
+#ifdef QUEUE_HAVE_FUTEX
+        if (queue->blocking) {
+            // Register as a waiter before the last try, so that a producer
+            // either sees the waiter or publishes the element this try gets
+            unsigned int seen = atomic_load(&(queue->not_empty));
+            atomic_fetch_add(&(queue->empty_waiters), 1);
+            atomic_thread_fence(memory_order_seq_cst);
+            bool empty = __mpmc_queue_dequeue(queue, element_size, element);
+            if (empty) {
+                _mpmc_queue_sleep(&(queue->not_empty), seen);
+            }
+            atomic_fetch_sub(&(queue->empty_waiters), 1);
+            if (!empty) {
+                return false;
+            }
+            continue;
+        }
+#endif
+        _mpmc_queue_yield();
+    }
+    return false;
+}
+
+
+/**
+ * Returns if there are any elements in the queue
+ * @note With other threads using the queue, the result may be
+ *       outdated by the time it is returned
+ *
+ * @param queue The queue to check if empty
+ * @return True if there are 0 elements in the queue,
+ *         False if not empty or if NULL queue
+ */
+bool __mpmc_queue_is_empty(mpmc_queue_t *queue)
+{
+    if (queue != NULL)
+    {
+        return __mpmc_queue_get_num_elements(queue) == 0;
+    }
+    return 0;
+}
+
+
+/**
+ * Returns the number of items in the queue (including items that are
+ * still being copied in or out)
+ * @note With other threads using the queue, the result may be
+ *       outdated by the time it is returned
+ *
+ * @param queue The queue to retrieve the number of elements from
+ * @return The number of elements in the queue (0 if queue is NULL)
+ */
+size_t __mpmc_queue_get_num_elements(mpmc_queue_t *queue)
+{
+    if (queue != NULL)
+    {
+        size_t dequeue_pos = atomic_load_explicit(&(queue->dequeue_pos), memory_order_acquire);
+        size_t enqueue_pos = atomic_load_explicit(&(queue->enqueue_pos), memory_order_acquire);
+        size_t count = enqueue_pos - dequeue_pos;
+        return count > queue->mask + 1 ? queue->mask + 1 : count;
+    }
+    return 0;
+}
+
+
+/**
+ * Returns the maximum number of items the queue can hold
+ *
+ * @param queue The queue to check
+ * @return The capacity of the queue (0 if queue is NULL)
+ */
+size_t __mpmc_queue_get_capacity(mpmc_queue_t *queue)
+{
+    if (queue != NULL)
+    {
+        return queue->mask + 1;
+    }
+    return 0;
+}
+
+
+/**
+ * Get the slot for an index
+ *
+ * @param queue The queue to index
+ * @param element_size [internal use] The size of an element stored in the queue
+ * @param index The (unwrapped) queue index
+ * @return A pointer to the slot
+ */
+static char *_spsc_queue_slot(spsc_queue_t *queue, size_t element_size, size_t index)
+{
+    return queue->table + (element_size * (index & queue->mask));
+}
+
+
+/**
+ * Copy n items into consecutive slots, wrapping around the end of the table
+ *
+ * @param queue The queue
+ * @param element_size [internal use] The size of an element stored in the queue
+ * @param index The (unwrapped) index of the first slot
+ * @param elements The items to copy
+ * @param n The number of items
+ */
+static void _spsc_queue_copy_in(spsc_queue_t *queue, size_t element_size, size_t index, const char *elements, size_t n)
+{
+    size_t first = queue->mask + 1 - (index & queue->mask);
+    if (first > n) {
+        first = n;
+    }
+    memcpy(_spsc_queue_slot(queue, element_size, index), elements, element_size * first);
+    if (n > first) {
+        memcpy(queue->table, elements + element_size * first, element_size * (n - first));
+    }
+}
+
+
+/**
+ * Copy n items out of consecutive slots, wrapping around the end of the table
+ *
+ * @param queue The queue
+ * @param element_size [internal use] The size of an element stored in the queue
+ * @param index The (unwrapped) index of the first slot
+ * @param elements The location to copy the items to
+ * @param n The number of items
+ */
+static void _spsc_queue_copy_out(spsc_queue_t *queue, size_t element_size, size_t index, char *elements, size_t n)
+{
+    size_t first = queue->mask + 1 - (index & queue->mask);
+    if (first > n) {
+        first = n;
+    }
+    memcpy(elements, _spsc_queue_slot(queue, element_size, index), element_size * first);
+    if (n > first) {
+        memcpy(elements + element_size * first, queue->table, element_size * (n - first));
+    }
+}
+
+
+/**
+ * Round a size up to a multiple of the alignment of max_align_t
+ *
+ * @param bytes The size to round
+ * @return The rounded size
+ */
+static size_t _mpmc_queue_align(size_t bytes)
+{
+    return (bytes + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1);
+}
+
+
+/**
+ * Get the sequence number of the slot for an index
+ *
+ * @param queue The queue to index
+ * @param index The (unwrapped) queue index
+ * @return A pointer to the slot's sequence number
+ */
+static _Atomic size_t *_mpmc_queue_sequence(mpmc_queue_t *queue, size_t index)
+{
+    return (_Atomic size_t *)(queue->table + queue->slot_size * (index & queue->mask));
+}
+
+
+/**
+ * Get the element storage of the slot for an index
+ *
+ * @param queue The queue to index
+ * @param index The (unwrapped) queue index
+ * @return A pointer to the slot's element
+ */
+static char *_mpmc_queue_data(mpmc_queue_t *queue, size_t index)
+{
+    return (char *)_mpmc_queue_sequence(queue, index) + _mpmc_queue_align(sizeof(_Atomic size_t));
+}
+
+
+/**
+ * Give up the CPU while waiting on a full (or empty) queue
+ */
+static void _mpmc_queue_yield(void)
+{
+#ifdef QUEUE_HAVE_YIELD
+    sched_yield();
+#endif
+}
+
+
+#ifdef QUEUE_HAVE_FUTEX
+/**
+ * Wake one sleeping thread, if there are any, after the queue changed
+ *
+ * @param event The event counter the threads sleep on
+ * @param waiters The number of threads sleeping on event
+ */
+static void _mpmc_queue_wake(_Atomic unsigned int *event, _Atomic unsigned int *waiters)
+{
+    // Pairs with the fence in the waiting thread: either the waiter is seen
+    // here, or the waiter's last try sees the change made by the caller
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(waiters, memory_order_relaxed)) {
+        atomic_fetch_add(event, 1);
+        syscall(SYS_futex, (unsigned int *)event, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+}
+
+
+/**
+ * Sleep until an event counter changes from a value seen earlier. Returns
+ * immediately if it has already changed.
+ *
+ * @param event The event counter to sleep on
+ * @param seen The value of the counter seen before the last try
+ */
+static void _mpmc_queue_sleep(_Atomic unsigned int *event, unsigned int seen)
+{
+    syscall(SYS_futex, (unsigned int *)event, FUTEX_WAIT_PRIVATE, seen, NULL, NULL, 0);
+}
+#endif
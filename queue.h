@@ -0,0 +1,221 @@
+/**
+ * Bounded concurrent queues in c
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-18: Initial creation (single-producer/single-consumer queue)
+ * 2026-10-19: Add multi-producer/multi-consumer queue
+ *
+ * USAGE:
+ * Define QUEUE_DATA_T as the data type to be stored in the queue structure.
+ * Define QUEUE_DATA_NAME as the data name for the associated function calls.
+ * **NOTE**: Do not enclose the above macros in parens! For example, if the
+ *           data type is char* , define the macros as char* , not (char*)
+ * **NOTE**: Like the Stack data structure, elements are stored by value.
+ *
+ * The queues are FIFO ring buffers with a fixed capacity (rounded up to a
+ * power of 2), so enqueue() fails on a full queue instead of growing it.
+ *
+ * SPSC queue (spsc_queue_*):
+ * Exactly one thread may enqueue and exactly one (other) thread may
+ * dequeue at a time. Both ends are wait-free. The head index (written by
+ * the consumer) and the tail index (written by the producer) are on
+ * separate cache lines, and each side keeps a private copy of the other
+ * side's index which is only re-read when the queue looks full (or empty).
+ * As long as the queue is neither, an enqueue() or dequeue() touches no
+ * cache line written by the other thread besides the slot itself.
+ * enqueue_n() and dequeue_n() move up to n elements with one index update,
+ * so a batch costs about the same synchronization as a single element.
+ *
+ * MPMC queue (mpmc_queue_*):
+ * Any number of threads may enqueue and dequeue at once (Vyukov's bounded
+ * queue). Every slot has a sequence number which tells whether it is ready
+ * to be written or read for a given lap around the ring. A thread claims a
+ * slot with one compare-and-swap on the enqueue (or dequeue) index and then
+ * publishes it with a store to the slot's sequence number, so threads only
+ * contend on the index, never on each other's slots.
+ * enqueue() and dequeue() never block and fail on a full (or empty) queue.
+ * enqueue_wait() and dequeue_wait() retry until they succeed. They spin
+ * for a short while and then, if the queue was created with blocking set,
+ * sleep on a futex (Linux only) until the other side makes progress.
+ * Otherwise they keep yielding the CPU. Only blocking queues pay for
+ * checking for sleeping threads after every successful operation.
+ * **NOTE**: Requires C11 atomics (<stdatomic.h>)
+ */
+
+#include <stddef.h> // size_t
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#define QUEUE_CACHE_LINE 64
+#define QUEUE_MIN_SIZE 2
+#define QUEUE_SPIN_COUNT 64
+
+#define _QUEUE_GLUE(x, y) x##y
+#define QUEUE_GLUE(x, y) _QUEUE_GLUE(x, y)
+
+typedef struct spsc_queue_t {
+    _Alignas(QUEUE_CACHE_LINE) _Atomic size_t head;    // Next index to dequeue (written by the consumer)
+    size_t tail_cache;                                  // Consumer's copy of tail
+    _Alignas(QUEUE_CACHE_LINE) _Atomic size_t tail;    // Next index to enqueue (written by the producer)
+    size_t head_cache;                                  // Producer's copy of head
+    _Alignas(QUEUE_CACHE_LINE) size_t mask;            // Number of slots - 1 (the number of slots is a power of 2)
+    char *table;                                        // The slots
+} spsc_queue_t;
+
+bool __spsc_queue_init(spsc_queue_t **queue, size_t element_size, size_t capacity);
+void __spsc_queue_destroy(spsc_queue_t **queue);
+bool __spsc_queue_enqueue(spsc_queue_t *queue, size_t element_size, const void *element);
+size_t __spsc_queue_enqueue_n(spsc_queue_t *queue, size_t element_size, const void *elements, size_t n);
+bool __spsc_queue_dequeue(spsc_queue_t *queue, size_t element_size, void *element);
+size_t __spsc_queue_dequeue_n(spsc_queue_t *queue, size_t element_size, void *elements, size_t n);
+bool __spsc_queue_is_empty(spsc_queue_t *queue);
+size_t __spsc_queue_get_num_elements(spsc_queue_t *queue);
+size_t __spsc_queue_get_capacity(spsc_queue_t *queue);
+
+typedef struct mpmc_queue_t {
+    _Alignas(QUEUE_CACHE_LINE) _Atomic size_t enqueue_pos; // Next index to enqueue
+    _Alignas(QUEUE_CACHE_LINE) _Atomic size_t dequeue_pos; // Next index to dequeue
+    _Alignas(QUEUE_CACHE_LINE) size_t mask;                // Number of slots - 1 (the number of slots is a power of 2)
+    size_t slot_size;                                       // Bytes per slot (sequence number + element)
+    char *table;                                            // The slots
+    bool blocking;                                          // Whether waiting threads sleep
+    _Alignas(QUEUE_CACHE_LINE) _Atomic unsigned int not_empty; // Bumped to wake threads waiting to dequeue
+    _Atomic unsigned int not_full;                          // Bumped to wake threads waiting to enqueue
+    _Atomic unsigned int empty_waiters;                     // Number of threads asleep in dequeue_wait()
+    _Atomic unsigned int full_waiters;                      // Number of threads asleep in enqueue_wait()
+} mpmc_queue_t;
+
+bool __mpmc_queue_init(mpmc_queue_t **queue, size_t element_size, size_t capacity, bool blocking);
+void __mpmc_queue_destroy(mpmc_queue_t **queue);
+bool __mpmc_queue_enqueue(mpmc_queue_t *queue, size_t element_size, const void *element);
+bool __mpmc_queue_enqueue_wait(mpmc_queue_t *queue, size_t element_size, const void *element);
+bool __mpmc_queue_dequeue(mpmc_queue_t *queue, size_t element_size, void *element);
+bool __mpmc_queue_dequeue_wait(mpmc_queue_t *queue, size_t element_size, void *element);
+bool __mpmc_queue_is_empty(mpmc_queue_t *queue);
+size_t __mpmc_queue_get_num_elements(mpmc_queue_t *queue);
+size_t __mpmc_queue_get_capacity(mpmc_queue_t *queue);
+
+#endif
+
+// Now on to the "type generic weirdness"
+#ifndef __QUEUE_QUEUE_C
+
+#if !defined(QUEUE_DATA_NAME) || !defined(QUEUE_DATA_T)
+# error "Must define both QUEUE_DATA_NAME and QUEUE_DATA_T before including queue.h"
+#endif
+
+#define __SPSC_QUEUE_T QUEUE_GLUE(QUEUE_DATA_NAME, _spsc_queue_t)
+#define __MPMC_QUEUE_T QUEUE_GLUE(QUEUE_DATA_NAME, _mpmc_queue_t)
+
+// Wrapping the untyped queues gives each generic type its own structs so
+// that mixing queues of different types is caught at compile time
+typedef struct __SPSC_QUEUE_T {
+    spsc_queue_t queue;
+} __SPSC_QUEUE_T;
+
+typedef struct __MPMC_QUEUE_T {
+    mpmc_queue_t queue;
+} __MPMC_QUEUE_T;
+
+// Function prototypes
+static inline bool QUEUE_GLUE(QUEUE_DATA_NAME, _spsc_queue_init)(__SPSC_QUEUE_T **queue, size_t capacity)
+{
+    return __spsc_queue_init((spsc_queue_t**)queue, sizeof(QUEUE_DATA_T), capacity);
+}
+
+static inline void QUEUE_GLUE(QUEUE_DATA_NAME, _spsc_queue_destroy)(__SPSC_QUEUE_T **queue)
+{
+    __spsc_queue_destroy((spsc_queue_t**)queue);
+}
+
+static inline bool QUEUE_GLUE(QUEUE_DATA_NAME, _spsc_queue_enqueue)(__SPSC_QUEUE_T *queue, QUEUE_DATA_T element)
+{
+    return __spsc_queue_enqueue((spsc_queue_t*)queue, sizeof(QUEUE_DATA_T), (const void *)&element);
+}
+
+static inline size_t QUEUE_GLUE(QUEUE_DATA_NAME, _spsc_queue_enqueue_n)(__SPSC_QUEUE_T *queue, const QUEUE_DATA_T *elements, size_t n)
+{
+    return __spsc_queue_enqueue_n((spsc_queue_t*)queue, sizeof(QUEUE_DATA_T), (const void *)elements, n);
+}
+
+static inline bool QUEUE_GLUE(QUEUE_DATA_NAME, _spsc_queue_dequeue)(__SPSC_QUEUE_T *queue, QUEUE_DATA_T *element)
+{
+    return __spsc_queue_dequeue((spsc_queue_t*)queue, sizeof(QUEUE_DATA_T), (void *)element);
+}
+
+static inline size_t QUEUE_GLUE(QUEUE_DATA_NAME, _spsc_queue_dequeue_n)(__SPSC_QUEUE_T *queue, QUEUE_DATA_T *elements, size_t n)
+{
+    return __spsc_queue_dequeue_n((spsc_queue_t*)queue, sizeof(QUEUE_DATA_T), (void *)elements, n);
+}
+
+static inline bool QUEUE_GLUE(QUEUE_DATA_NAME, _spsc_queue_is_empty)(__SPSC_QUEUE_T *queue)
+{
+    return __spsc_queue_is_empty((spsc_queue_t*)queue);
+}
+
+static inline size_t QUEUE_GLUE(QUEUE_DATA_NAME, _spsc_queue_get_num_elements)(__SPSC_QUEUE_T *queue)
+{
+    return __spsc_queue_get_num_elements((spsc_queue_t*)queue);
+}
+
+static inline size_t QUEUE_GLUE(QUEUE_DATA_NAME, _spsc_queue_get_capacity)(__SPSC_QUEUE_T *queue)
+{
+    return __spsc_queue_get_capacity((spsc_queue_t*)queue);
+}
+
+static inline bool QUEUE_GLUE(QUEUE_DATA_NAME, _mpmc_queue_init)(__MPMC_QUEUE_T **queue, size_t capacity, bool blocking)
+{
+    return __mpmc_queue_init((mpmc_queue_t**)queue, sizeof(QUEUE_DATA_T), capacity, blocking);
+}
+
+static inline void QUEUE_GLUE(QUEUE_DATA_NAME, _mpmc_queue_destroy)(__MPMC_QUEUE_T **queue)
+{
+    __mpmc_queue_destroy((mpmc_queue_t**)queue);
+}
+
+static inline bool QUEUE_GLUE(QUEUE_DATA_NAME, _mpmc_queue_enqueue)(__MPMC_QUEUE_T *queue, QUEUE_DATA_T element)
+{
+    return __mpmc_queue_enqueue((mpmc_queue_t*)queue, sizeof(QUEUE_DATA_T), (const void *)&element);
+}
+
+static inline bool QUEUE_GLUE(QUEUE_DATA_NAME, _mpmc_queue_enqueue_wait)(__MPMC_QUEUE_T *queue, QUEUE_DATA_T element)
+{
+    return __mpmc_queue_enqueue_wait((mpmc_queue_t*)queue, sizeof(QUEUE_DATA_T), (const void *)&element);
+}
+
+static inline bool QUEUE_GLUE(QUEUE_DATA_NAME, _mpmc_queue_dequeue)(__MPMC_QUEUE_T *queue, QUEUE_DATA_T *element)
+{
+    return __mpmc_queue_dequeue((mpmc_queue_t*)queue, sizeof(QUEUE_DATA_T), (void *)element);
+}
+
+static inline bool QUEUE_GLUE(QUEUE_DATA_NAME, _mpmc_queue_dequeue_wait)(__MPMC_QUEUE_T *queue, QUEUE_DATA_T *element)
+{
+    return __mpmc_queue_dequeue_wait((mpmc_queue_t*)queue, sizeof(QUEUE_DATA_T), (void *)element);
+}
+
+static inline bool QUEUE_GLUE(QUEUE_DATA_NAME, _mpmc_queue_is_empty)(__MPMC_QUEUE_T *queue)
+{
+    return __mpmc_queue_is_empty((mpmc_queue_t*)queue);
+}
+
+static inline size_t QUEUE_GLUE(QUEUE_DATA_NAME, _mpmc_queue_get_num_elements)(__MPMC_QUEUE_T *queue)
+{
+    return __mpmc_queue_get_num_elements((mpmc_queue_t*)queue);
+}
+
+static inline size_t QUEUE_GLUE(QUEUE_DATA_NAME, _mpmc_queue_get_capacity)(__MPMC_QUEUE_T *queue)
+{
+    return __mpmc_queue_get_capacity((mpmc_queue_t*)queue);
+}
+
+#undef QUEUE_DATA_T
+#undef QUEUE_DATA_NAME
+#undef __SPSC_QUEUE_T
+#undef __MPMC_QUEUE_T
+
+#endif
+
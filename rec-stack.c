@@ -0,0 +1,346 @@
+/**
+ * Variable-length record stack implementation in c
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-18: Initial creation
+ *
+ * USAGE: see rec-stack.h
+ */
+
+#include <stdlib.h>
+#include <string.h> // memcpy()
+
+#include "rec-stack.h"
+
+// Helper functions
+static inline size_t _rec_stack_padded(size_t len);
+static inline size_t _rec_stack_read_len(rec_stack_t *stack, size_t offset);
+static bool _rec_stack_reserve(rec_stack_t *stack, size_t bytes);
+
+
+/**
+ * Heap-allocate a new record stack
+ *
+ * @param **stack Pointer to the stack
+ * @param initial_bytes Initial size of the record buffer in bytes
+ *                      (0 for REC_STACK_DEFAULT_SIZE)
+ * @return false on success, true on failure (memory allocation failure)
+ */
+bool rec_stack_init(rec_stack_t **stack, size_t initial_bytes)
+{
+    *stack = malloc(sizeof(**stack));
+    if (!*stack) {
+        return true;
+    }
+    (*stack)->capacity = initial_bytes ? initial_bytes : REC_STACK_DEFAULT_SIZE;
+    (*stack)->buffer = malloc((*stack)->capacity);
+    if (!((*stack)->buffer)) {
+        free(*stack);
+        *stack = NULL;
+        return true;
+    }
+    (*stack)->used = 0;
+    (*stack)->number_of_records = 0;
+    return false;
+}
+
+
+/**
+ * Remove all records from the stack. The buffer is kept.
+ *
+ * @param *stack The stack to clear
+ */
+void rec_stack_clear(rec_stack_t *stack)
+{
+    if (stack != NULL)
+    {
+        stack->used = 0;
+        stack->number_of_records = 0;
+    }
+}
+
+
+/**
+ * Returns if there are any records in the stack
+ *
+ * @param stack The stack to check if empty
+ * @return True if there are 0 records in the stack,
+ *         False if not empty or if NULL stack
+ */
+bool rec_stack_is_empty(rec_stack_t *stack)
+{
+    if (stack != NULL)
+    {
+        return (stack->number_of_records) == 0;
+    }
+    return 0;
+}
+
+
+/**
+ * Free a record stack
+ * @note The *stack is set to NULL
+ *
+ * @param **stack The stack to free
+ */
+void rec_stack_destroy(rec_stack_t **stack)
+{
+    if (!stack || !*stack) {
+        return;
+    }
+    free((*stack)->buffer);
+    free(*stack);
+    *stack = NULL;
+}
+
+
+/**
+ * Push a copy of a byte string onto the top of the stack
+ *
+ * @param *stack The stack to push onto
+ * @param *data The bytes to push (may be NULL if len is 0)
+ * @param len The number of bytes in the record
+ * @return false on success, true on failure (memory allocation failure
+ *         or null *data pointer)
+ */
+bool rec_stack_push(rec_stack_t *stack, const void *data, size_t len)
+{
+    if (!data && len) {
+        return true;
+    }
+    size_t payload = _rec_stack_padded(len);
+    if (payload < len || payload > (size_t)-1 - 2 * sizeof(size_t)) {
+        return true;
+    }
+    size_t record = sizeof(size_t) + payload + sizeof(size_t);
+    if (_rec_stack_reserve(stack, record)) {
+        return true;
+    }
+
+    char *start = stack->buffer + stack->used;
+    memcpy(start, &len, sizeof(len));
+    if (len) {
+        memcpy(start + sizeof(size_t), data, len);
+    }
+    memcpy(start + sizeof(size_t) + payload, &len, sizeof(len));
+
+    stack->used += record;
+    ++(stack->number_of_records);
+    return false;
+}
+
+
+/**
+ * Remove the top record from the stack and copy it out
+ *
+ * @param *stack The stack to remove the record from
+ * @param *data The location to copy the record to
+ * @param size The number of bytes available at *data
+ * @param *len Set to the length of the top record (may be NULL). This
+ *             is also set if the record does not fit in *data.
+ * @return false on success, true on empty stack or if the record
+ *         does not fit in size bytes (nothing is pop'd)
+ */
+bool rec_stack_pop(rec_stack_t *stack, void *data, size_t size, size_t *len)
+{
+    size_t record_len;
+    const void *record = rec_stack_peek(stack, &record_len);
+    if (!record) {
+        return true;
+    }
+    if (len) {
+        *len = record_len;
+    }
+    if (record_len > size || (!data && record_len)) {
+        return true;
+    }
+    if (record_len) {
+        memcpy(data, record, record_len);
+    }
+    return rec_stack_drop(stack);
+}
+
+
+/**
+ * Remove the top record from the stack
+ *
+ * @param *stack The stack to remove the record from
+ * @return false on success, true on empty stack
+ */
+bool rec_stack_drop(rec_stack_t *stack)
+{
+    if (rec_stack_is_empty(stack)) {
+        return true;
+    }
+    size_t len = _rec_stack_read_len(stack, stack->used - sizeof(size_t));
+    stack->used -= sizeof(size_t) + _rec_stack_padded(len) + sizeof(size_t);
+    --(stack->number_of_records);
+    return false;
+}
+
+
+/**
+ * Get the top record of the stack without copying it
+ * @note The pointer is invalidated by the next push()
+ *
+ * @param *stack The stack to look at
+ * @param *len Set to the length of the top record (may be NULL)
+ * @return A pointer to the top record's bytes, NULL on empty stack
+ */
+const void *rec_stack_peek(rec_stack_t *stack, size_t *len)
+{
+    if (rec_stack_is_empty(stack)) {
+        return NULL;
+    }
+    size_t record_len = _rec_stack_read_len(stack, stack->used - sizeof(size_t));
+    if (len) {
+        *len = record_len;
+    }
+    return stack->buffer + stack->used - sizeof(size_t) - _rec_stack_padded(record_len);
+}
+
+
+/**
+ * Returns the number of records in the stack
+ *
+ * @param stack The stack to retrieve the number of records from
+ * @return The number of records in the stack (0 if stack is NULL)
+ */
+size_t rec_stack_get_num_records(rec_stack_t *stack)
+{
+    if (stack != NULL)
+    {
+        return stack->number_of_records;
+    }
+    return 0;
+}
+
+
+/**
+ * Returns the number of buffer bytes used by the stack's records,
+ * including their lengths and padding
+ *
+ * @param stack The stack to check
+ * @return The number of bytes in use (0 if stack is NULL)
+ */
+size_t rec_stack_get_bytes(rec_stack_t *stack)
+{
+    if (stack != NULL)
+    {
+        return stack->used;
+    }
+    return 0;
+}
+
+
+/**
+ * Set up an iterator over the records of a stack, from the bottom record
+ * to the top record
+ * @note The stack must not be modified while iterating
+ *
+ * @param *stack The stack to iterate over
+ * @param *itr The iterator to initialize
+ */
+void rec_stack_iterator_init(rec_stack_t *stack, rec_stack_itr_t *itr)
+{
+    itr->stack = stack;
+    itr->offset = 0;
+}
+
+
+/**
+ * Check if there are any more records to iterate over
+ *
+ * @param *itr The iterator to check
+ * @return true if there are more records, false otherwise
+ */
+bool rec_stack_iterator_has_next(rec_stack_itr_t *itr)
+{
+    return itr != NULL && itr->stack != NULL && itr->offset < itr->stack->used;
+}
+
+
+/**
+ * Get the next record (towards the top of the stack)
+ *
+ * @param *itr The iterator to advance
+ * @param *len Set to the length of the record (may be NULL)
+ * @return A pointer to the record's bytes, NULL if there are no more records
+ */
+const void *rec_stack_iterator_next(rec_stack_itr_t *itr, size_t *len)
+{
+    if (!rec_stack_iterator_has_next(itr)) {
+        return NULL;
+    }
+    size_t record_len = _rec_stack_read_len(itr->stack, itr->offset);
+    if (len) {
+        *len = record_len;
+    }
+    const char *record = itr->stack->buffer + itr->offset + sizeof(size_t);
+    itr->offset += sizeof(size_t) + _rec_stack_padded(record_len) + sizeof(size_t);
+    return record;
+}
+
+
+/**
+ * Round a record length up to a multiple of REC_STACK_ALIGN
+ *
+ * @param len The length of the record
+ * @return The number of bytes the payload takes up in the buffer
+ */
+static size_t _rec_stack_padded(size_t len)
+{
+    return (len + REC_STACK_ALIGN - 1) & ~(REC_STACK_ALIGN - 1);
+}
+
+
+/**
+ * Read a stored record length
+ *
+ * @param stack The stack to read from
+ * @param offset The byte offset of the length
+ * @return The length
+ */
+static size_t _rec_stack_read_len(rec_stack_t *stack, size_t offset)
+{
+    size_t len;
+    memcpy(&len, stack->buffer + offset, sizeof(len));
+    return len;
+}
+
+
+/**
+ * Make room for at least bytes more bytes in the buffer, doubling its size
+ * (as many times as needed)
+ *
+ * @param stack The stack to grow
+ * @param bytes The number of bytes needed past the used part of the buffer
+ * @return false on success, true on failure (memory allocation failure)
+ */
+static bool _rec_stack_reserve(rec_stack_t *stack, size_t bytes)
+{
+    if (bytes > (size_t)-1 - stack->used) {
+        return true;
+    }
+    size_t needed = stack->used + bytes;
+    if (needed <= stack->capacity) {
+        return false;
+    }
+
+    size_t new_capacity = stack->capacity;
+    while (new_capacity < needed) {
+        if (new_capacity > (size_t)-1 / 2) {
+            new_capacity = needed;
+            break;
+        }
+        new_capacity *= 2;
+    }
+    char *tmp = realloc(stack->buffer, new_capacity);
+    if (!tmp) {
+        return true;
+    }
+    stack->buffer = tmp;
+    stack->capacity = new_capacity;
+    return false;
+}
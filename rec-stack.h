@@ -0,0 +1,60 @@
+/**
+ * Variable-length record stack implementation in c
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-18: Initial creation
+ *
+ * USAGE:
+ * Unlike the Stack data structure, each element (record) is a byte string
+ * of any length. Records are packed back to back in a single buffer as
+ *
+ *     [length][payload, padded to REC_STACK_ALIGN bytes][length]
+ *
+ * The trailing copy of the length lets pop() find the start of the top
+ * record in O(1), while the leading copy lets the iterator walk the
+ * records from the bottom up.
+ *
+ * Payloads are aligned to REC_STACK_ALIGN bytes, so a record may hold any
+ * struct that does not need a stricter alignment.
+ * **NOTE**: Pointers returned by peek() and the iterator are invalidated
+ *           by push() (which may move the buffer).
+ */
+
+#ifndef REC_STACK_H
+#define REC_STACK_H
+
+#include <stddef.h> // size_t
+#include <stdbool.h>
+
+#define REC_STACK_ALIGN (sizeof(size_t))
+#define REC_STACK_DEFAULT_SIZE 4096
+
+typedef struct rec_stack_t {
+    char *buffer;                          // Packed records
+    size_t used;                           // Bytes of buffer in use
+    size_t capacity;                       // Size of buffer in bytes
+    size_t number_of_records;              // Number of records on the stack
+} rec_stack_t;
+
+typedef struct rec_stack_itr_t {
+    rec_stack_t *stack;
+    size_t offset;                         // Byte offset of the next record
+} rec_stack_itr_t;
+
+bool rec_stack_init(rec_stack_t **stack, size_t initial_bytes);
+void rec_stack_clear(rec_stack_t *stack);
+bool rec_stack_is_empty(rec_stack_t *stack);
+void rec_stack_destroy(rec_stack_t **stack);
+bool rec_stack_push(rec_stack_t *stack, const void *data, size_t len);
+bool rec_stack_pop(rec_stack_t *stack, void *data, size_t size, size_t *len);
+bool rec_stack_drop(rec_stack_t *stack);
+const void *rec_stack_peek(rec_stack_t *stack, size_t *len);
+size_t rec_stack_get_num_records(rec_stack_t *stack);
+size_t rec_stack_get_bytes(rec_stack_t *stack);
+
+void rec_stack_iterator_init(rec_stack_t *stack, rec_stack_itr_t *itr);
+bool rec_stack_iterator_has_next(rec_stack_itr_t *itr);
+const void *rec_stack_iterator_next(rec_stack_itr_t *itr, size_t *len);
+
+#endif
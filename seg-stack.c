@@ -0,0 +1,283 @@
+/**
+ * Segmented stack implementation in c
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-18: Initial creation
+ *
+ * USAGE: see seg-stack.h
+ */
+
+#define __SEGSTACK_SEGSTACK_C
+#include "seg-stack.h"
+#undef __SEGSTACK_SEGSTACK_C
+
+// Helper functions
+static inline char *_seg_stack_slot(seg_stack_segment_t *segment, size_t element_size, size_t index);
+static void _seg_stack_release_top(seg_stack_t *stack);
+
+
+/**
+ * Heap-allocate a new segmented stack. No segment is allocated
+ * until the first push.
+ *
+ * @param **stack Pointer to the stack
+ * @param segment_size Number of elements per segment
+ *                     (0 for SEGSTACK_DEFAULT_SEGMENT_SIZE)
+ * @return false on success, true on failure (memory allocation failure)
+ */
+bool __seg_stack_init(seg_stack_t **stack, size_t segment_size)
+{
+    *stack = malloc(sizeof(**stack));
+    if (!*stack) {
+        return true;
+    }
+    (*stack)->top = NULL;
+    (*stack)->spare = NULL;
+    (*stack)->top_count = 0;
+    (*stack)->segment_size = segment_size ? segment_size : SEGSTACK_DEFAULT_SEGMENT_SIZE;
+    (*stack)->number_of_items_in_table = 0;
+    return false;
+}
+
+
+/**
+ * Remove all elements from the stack and free all of its segments
+ * (except for one spare). Does not free any contained data.
+ *
+ * @param *stack The stack to clear
+ */
+void __seg_stack_clear(seg_stack_t *stack)
+{
+    while (stack->top) {
+        _seg_stack_release_top(stack);
+    }
+    stack->top_count = 0;
+    stack->number_of_items_in_table = 0;
+}
+
+
+/**
+ * Returns if there are any elements in the stack
+ *
+ * @param stack The stack to check if empty
+ * @return True if there are 0 elements in the stack,
+ *         False if not empty or if NULL stack
+ */
+bool __seg_stack_is_empty(seg_stack_t *stack)
+{
+    if (stack != NULL)
+    {
+        return (stack->number_of_items_in_table) == 0;
+    }
+    return 0;
+}
+
+
+/**
+ * Free a segmented stack data structure
+ * @note The *stack is set to NULL
+ *
+ * @param **stack The stack to free
+ */
+void __seg_stack_destroy(seg_stack_t **stack)
+{
+    if (!stack || !*stack) {
+        return;
+    }
+    __seg_stack_clear(*stack);
+    free((*stack)->spare);
+    free(*stack);
+    *stack = NULL;
+}
+
+
+/**
+ * Get the element on the top of the stack
+ *
+ * @param *stack The stack to look at
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @param *element A pointer to the location to store the peek'd value
+ * @return false on success, true on empty stack or null *element pointer
+ */
+bool __seg_stack_peek(seg_stack_t *stack, size_t element_size, void *element)
+{
+    if (!element || __seg_stack_is_empty(stack)) {
+        return true;
+    }
+    memcpy(element, _seg_stack_slot(stack->top, element_size, stack->top_count - 1), element_size);
+    return false;
+}
+
+
+/**
+ * Get the element at an index relative to the top of the stack.
+ * This walks one segment per segment_size elements below the top.
+ *
+ * @param *stack The stack to look at
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @param *element A pointer to the location to store the peek'd value
+ * @param index The index, relative to the top of the stack, to retrieve.
+ *              If 0 is given, this behaves the same as __seg_stack_peek()
+ * @return false on success, true on empty stack or null *element pointer or
+ *         index outside of stack size
+ */
+bool __seg_stack_peeki(seg_stack_t *stack, size_t element_size, void *element, size_t index)
+{
+    if (!element || __seg_stack_is_empty(stack) || index >= stack->number_of_items_in_table) {
+        return true;
+    }
+
+    seg_stack_segment_t *segment = stack->top;
+    size_t count = stack->top_count;
+    while (index >= count) {
+        index -= count;
+        segment = segment->prev;
+        count = stack->segment_size;
+    }
+    memcpy(element, _seg_stack_slot(segment, element_size, count - 1 - index), element_size);
+    return false;
+}
+
+
+/**
+ * Get a pointer to the element on the top of the stack. The element is
+ * never moved, so the pointer stays valid until the element is popped
+ * (or the stack is cleared or destroyed).
+ *
+ * @param *stack The stack to look at
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @return A pointer to the top element, NULL on empty stack
+ */
+void *__seg_stack_top_ptr(seg_stack_t *stack, size_t element_size)
+{
+    if (__seg_stack_is_empty(stack)) {
+        return NULL;
+    }
+    return _seg_stack_slot(stack->top, element_size, stack->top_count - 1);
+}
+
+
+/**
+ * Remove the top element on the stack and return its value
+ *
+ * @param *stack The stack to remove the element from
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @param *element A pointer to the location to store the pop'd value
+ * @return false on success, true on empty stack or null *element pointer
+ */
+bool __seg_stack_pop(seg_stack_t *stack, size_t element_size, void *element)
+{
+    if (__seg_stack_peek(stack, element_size, element)) {
+        return true;
+    }
+    return __seg_stack_drop(stack);
+}
+
+
+/**
+ * Remove the top element on the stack
+ *
+ * @param *stack The stack to remove the element from
+ * @return false on success, true on empty stack
+ */
+bool __seg_stack_drop(seg_stack_t *stack)
+{
+    if (__seg_stack_is_empty(stack)) {
+        return true;
+    }
+
+    --(stack->number_of_items_in_table);
+    if (--(stack->top_count) == 0) {
+        _seg_stack_release_top(stack);
+    }
+    return false;
+}
+
+
+/**
+ * Push an item onto the top of the stack. Allocates at most one segment
+ * and never moves the elements already on the stack.
+ *
+ * @param *stack The stack to push the item onto
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @param *element The data to push onto the stack
+ * @return false on success, true on failure (memory allocation failure)
+ */
+bool __seg_stack_push(seg_stack_t *stack, size_t element_size, const void *element)
+{
+    if (!stack->top || stack->top_count == stack->segment_size) {
+        seg_stack_segment_t *segment = stack->spare;
+        if (segment) {
+            stack->spare = NULL;
+        }
+        else {
+            if (stack->segment_size > ((size_t)-1 - sizeof(*segment)) / element_size) {
+                return true;
+            }
+            segment = malloc(sizeof(*segment) + element_size * stack->segment_size);
+            if (!segment) {
+                return true;
+            }
+        }
+        segment->prev = stack->top;
+        stack->top = segment;
+        stack->top_count = 0;
+    }
+
+    memcpy(_seg_stack_slot(stack->top, element_size, stack->top_count), element, element_size);
+    ++(stack->top_count);
+    ++(stack->number_of_items_in_table);
+    return false;
+}
+
+
+/**
+ * Returns the number of items in the stack
+ *
+ * @param stack The stack to retrieve the number of elements from
+ * @return The number of elements in the stack (0 if stack is NULL)
+ */
+size_t __seg_stack_get_num_elements(seg_stack_t *stack)
+{
+    if (stack != NULL)
+    {
+        return (stack->number_of_items_in_table);
+    }
+    return 0;
+}
+
+
+/**
+ * Get the address of an element slot within a segment
+ *
+ * @param segment The segment
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @param index The slot index within the segment
+ * @return A pointer to the slot
+ */
+static char *_seg_stack_slot(seg_stack_segment_t *segment, size_t element_size, size_t index)
+{
+    return (char *)segment->table + (element_size * index);
+}
+
+
+/**
+ * Unlink the (emptied) top segment, keeping it as the spare segment.
+ * The segment below becomes the top, and it is full.
+ *
+ * @param stack The stack to release the top segment of
+ */
+static void _seg_stack_release_top(seg_stack_t *stack)
+{
+    seg_stack_segment_t *segment = stack->top;
+    stack->top = segment->prev;
+    stack->top_count = stack->top ? stack->segment_size : 0;
+
+    if (stack->spare) {
+        free(segment);
+    }
+    else {
+        stack->spare = segment;
+    }
+}
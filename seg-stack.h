@@ -0,0 +1,141 @@
+/**
+ * Segmented stack implementation in c
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-18: Initial creation
+ *
+ * USAGE:
+ * Define SEGSTACK_DATA_T as the data type to be stored in the stack structure.
+ * Define SEGSTACK_DATA_NAME as the data name for the associated function calls.
+ * **NOTE**: Do not enclose the above macros in parens! For example, if the
+ *           data type is char* , define the macros as char* , not (char*)
+ * **NOTE**: Like the Stack data structure, elements are stored by value.
+ *
+ * Instead of one array that is realloc()'d as the stack grows, the stack is
+ * a linked list of fixed-size segments. Growing the stack allocates one more
+ * segment and never copies existing elements, so an element stays at the
+ * same address for as long as it is on the stack (see top_ptr()).
+ *
+ * When popping empties a segment, it is kept as a spare for the next push
+ * onto a new segment, so that pushing and popping across a segment boundary
+ * does not malloc() and free() a segment every time.
+ */
+
+#include <stddef.h> // size_t, max_align_t
+#include <stdbool.h>
+#include <string.h> // memcpy()
+#include <stdlib.h>
+
+#ifndef SEGSTACK_H
+#define SEGSTACK_H
+
+#define SEGSTACK_DEFAULT_SEGMENT_SIZE 1024
+
+#define _SEGSTACK_GLUE(x, y) x##y
+#define SEGSTACK_GLUE(x, y) _SEGSTACK_GLUE(x, y)
+
+typedef struct seg_stack_segment_t {
+    struct seg_stack_segment_t *prev;      // The segment below this one
+    max_align_t table[];                   // segment_size elements
+} seg_stack_segment_t;
+
+typedef struct seg_stack_t {
+    seg_stack_segment_t *top;              // Segment holding the top of the stack (NULL if empty)
+    seg_stack_segment_t *spare;            // Empty segment kept for reuse (NULL if none)
+    size_t top_count;                      // Number of items in the top segment
+    size_t segment_size;                   // Number of items per segment
+    size_t number_of_items_in_table;       // Number of items in the stack
+} seg_stack_t;
+
+bool __seg_stack_init(seg_stack_t **stack, size_t segment_size);
+void __seg_stack_clear(seg_stack_t *stack);
+bool __seg_stack_is_empty(seg_stack_t *stack);
+void __seg_stack_destroy(seg_stack_t **stack);
+bool __seg_stack_peek(seg_stack_t *stack, size_t element_size, void *element);
+bool __seg_stack_peeki(seg_stack_t *stack, size_t element_size, void *element, size_t index);
+void *__seg_stack_top_ptr(seg_stack_t *stack, size_t element_size);
+bool __seg_stack_pop(seg_stack_t *stack, size_t element_size, void *element);
+bool __seg_stack_drop(seg_stack_t *stack);
+bool __seg_stack_push(seg_stack_t *stack, size_t element_size, const void *element);
+size_t __seg_stack_get_num_elements(seg_stack_t *stack);
+
+#endif
+
+// Now on to the "type generic weirdness"
+#ifndef __SEGSTACK_SEGSTACK_C
+
+#if !defined(SEGSTACK_DATA_NAME) || !defined(SEGSTACK_DATA_T)
+# error "Must define both SEGSTACK_DATA_NAME and SEGSTACK_DATA_T before including seg-stack.h"
+#endif
+
+#define __SEGSTACK_T SEGSTACK_GLUE(SEGSTACK_DATA_NAME, _seg_stack_t)
+
+// Wrapping the untyped stack gives each generic type its own struct so
+// that mixing stacks of different types is caught at compile time
+typedef struct __SEGSTACK_T {
+    seg_stack_t stack;
+} __SEGSTACK_T;
+
+// Function prototypes
+static inline bool SEGSTACK_GLUE(SEGSTACK_DATA_NAME, _seg_stack_init)(__SEGSTACK_T **stack, size_t segment_size)
+{
+    return __seg_stack_init((seg_stack_t**)stack, segment_size);
+}
+
+static inline void SEGSTACK_GLUE(SEGSTACK_DATA_NAME, _seg_stack_clear)(__SEGSTACK_T *stack)
+{
+    __seg_stack_clear((seg_stack_t*)stack);
+}
+
+static inline bool SEGSTACK_GLUE(SEGSTACK_DATA_NAME, _seg_stack_is_empty)(__SEGSTACK_T *stack)
+{
+    return __seg_stack_is_empty((seg_stack_t*)stack);
+}
+
+static inline void SEGSTACK_GLUE(SEGSTACK_DATA_NAME, _seg_stack_destroy)(__SEGSTACK_T **stack)
+{
+    __seg_stack_destroy((seg_stack_t**)stack);
+}
+
+static inline bool SEGSTACK_GLUE(SEGSTACK_DATA_NAME, _seg_stack_peek)(__SEGSTACK_T *stack, SEGSTACK_DATA_T *element)
+{
+    return __seg_stack_peek((seg_stack_t*)stack, sizeof(SEGSTACK_DATA_T), (void *)element);
+}
+
+static inline bool SEGSTACK_GLUE(SEGSTACK_DATA_NAME, _seg_stack_peeki)(__SEGSTACK_T *stack, SEGSTACK_DATA_T *element, size_t index)
+{
+    return __seg_stack_peeki((seg_stack_t*)stack, sizeof(SEGSTACK_DATA_T), (void *)element, index);
+}
+
+static inline SEGSTACK_DATA_T *SEGSTACK_GLUE(SEGSTACK_DATA_NAME, _seg_stack_top_ptr)(__SEGSTACK_T *stack)
+{
+    return (SEGSTACK_DATA_T *)__seg_stack_top_ptr((seg_stack_t*)stack, sizeof(SEGSTACK_DATA_T));
+}
+
+static inline bool SEGSTACK_GLUE(SEGSTACK_DATA_NAME, _seg_stack_pop)(__SEGSTACK_T *stack, SEGSTACK_DATA_T *element)
+{
+    return __seg_stack_pop((seg_stack_t*)stack, sizeof(SEGSTACK_DATA_T), (void *)element);
+}
+
+static inline bool SEGSTACK_GLUE(SEGSTACK_DATA_NAME, _seg_stack_drop)(__SEGSTACK_T *stack)
+{
+    return __seg_stack_drop((seg_stack_t*)stack);
+}
+
+static inline bool SEGSTACK_GLUE(SEGSTACK_DATA_NAME, _seg_stack_push)(__SEGSTACK_T *stack, SEGSTACK_DATA_T element)
+{
+    return __seg_stack_push((seg_stack_t*)stack, sizeof(SEGSTACK_DATA_T), (const void *)&element);
+}
+
+static inline size_t SEGSTACK_GLUE(SEGSTACK_DATA_NAME, _seg_stack_get_num_elements)(__SEGSTACK_T *stack)
+{
+    return __seg_stack_get_num_elements((seg_stack_t*)stack);
+}
+
+#undef SEGSTACK_DATA_T
+#undef SEGSTACK_DATA_NAME
+#undef __SEGSTACK_T
+
+#endif
+
@@ -0,0 +1,527 @@
+/**
+ * Single-threaded benchmark for the stack and the queues
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-19: Initial creation
+ *
+ * USAGE:
+ *     gcc -std=c11 -O2 stack-bench.c stack.c queue.c -o stack-bench
+ *     ./stack-bench [operations per case]
+ *
+ * Runs each case in its own child process and prints the time per
+ * operation, the number of array resizes (get_num_resizes()) per million
+ * operations and the peak resident set size of that process
+ * (getrusage() ru_maxrss, which includes the few MiB of the process
+ * itself). The cases are:
+ *
+ *   push-pop/N       push all elements then pop them all, N byte elements,
+ *                    starting from a 16 element array that may shrink
+ *   drain/shrink     push 4096 elements then pop them all, repeatedly, on a
+ *   drain/noshrink   stack that may or may not shrink
+ *   edge/shrink      pop down past the shrink threshold and push back up
+ *   edge/noshrink    past the grow boundary, repeatedly, on a stack that
+ *                    may or may not shrink (resizes during the prefill are
+ *                    not counted)
+ *   dup-swap-rot     dup(), swap(), rot() and drop() on a 3 element stack
+ *   spsc             enqueue 512 elements then dequeue them, repeatedly,
+ *   mpmc-try         on a queue with a capacity of 1024 (the queues never
+ *   mpmc-blocking    resize)
+ *
+ * **NOTE**: Requires fork() and getrusage() (POSIX)
+ */
+
+#ifndef _DEFAULT_SOURCE
+# define _DEFAULT_SOURCE // clock_gettime(), getrusage() in strict C modes
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+typedef struct bytes4_t { unsigned char bytes[4]; } bytes4_t;
+typedef struct bytes16_t { unsigned char bytes[16]; } bytes16_t;
+typedef struct bytes64_t { unsigned char bytes[64]; } bytes64_t;
+typedef struct bytes256_t { unsigned char bytes[256]; } bytes256_t;
+
+#define STACK_DATA_T bytes4_t
+#define STACK_DATA_NAME bytes4
+#include "stack.h"
+
+#define STACK_DATA_T bytes16_t
+#define STACK_DATA_NAME bytes16
+#include "stack.h"
+
+#define STACK_DATA_T bytes64_t
+#define STACK_DATA_NAME bytes64
+#include "stack.h"
+
+#define STACK_DATA_T bytes256_t
+#define STACK_DATA_NAME bytes256
+#include "stack.h"
+
+#define STACK_DATA_T long
+#define STACK_DATA_NAME long
+#include "stack.h"
+
+#define QUEUE_DATA_T long
+#define QUEUE_DATA_NAME long
+#include "queue.h"
+
+#define BENCH_DEFAULT_OPS 1000000L
+#define BENCH_INITIAL_SIZE 16
+#define BENCH_DRAIN_DEPTH 4096
+#define BENCH_EDGE_DEPTH 4096
+#define BENCH_QUEUE_CAPACITY 1024
+#define BENCH_QUEUE_BATCH 512
+
+typedef struct bench_result_t {
+    double seconds;
+    double ops;                            // Operations timed
+    size_t resizes;                        // Array resizes during the timed operations
+} bench_result_t;
+
+typedef struct bench_t {
+    const char *name;
+    bool (*run)(long ops, bench_result_t *result);
+} bench_t;
+
+// Keeps popped elements alive so the loops are not optimized away
+static volatile unsigned long sink;
+
+// Helper functions
+static bool _push_pop_4(long ops, bench_result_t *result);
+static bool _push_pop_16(long ops, bench_result_t *result);
+static bool _push_pop_64(long ops, bench_result_t *result);
+static bool _push_pop_256(long ops, bench_result_t *result);
+static bool _drain(long ops, bench_result_t *result, bool allow_shrink);
+static bool _drain_shrink(long ops, bench_result_t *result);
+static bool _drain_noshrink(long ops, bench_result_t *result);
+static bool _edge(long ops, bench_result_t *result, bool allow_shrink);
+static bool _edge_shrink(long ops, bench_result_t *result);
+static bool _edge_noshrink(long ops, bench_result_t *result);
+static bool _dup_swap_rot(long ops, bench_result_t *result);
+static bool _spsc(long ops, bench_result_t *result);
+static bool _mpmc(long ops, bench_result_t *result, bool blocking);
+static bool _mpmc_try(long ops, bench_result_t *result);
+static bool _mpmc_blocking(long ops, bench_result_t *result);
+static bool _bench_run(const bench_t *bench, long ops);
+static double _now(void);
+
+
+int main(int argc, char **argv)
+{
+    static const bench_t benches[] = {
+        {"push-pop/4", _push_pop_4},
+        {"push-pop/16", _push_pop_16},
+        {"push-pop/64", _push_pop_64},
+        {"push-pop/256", _push_pop_256},
+        {"drain/shrink", _drain_shrink},
+        {"drain/noshrink", _drain_noshrink},
+        {"edge/shrink", _edge_shrink},
+        {"edge/noshrink", _edge_noshrink},
+        {"dup-swap-rot", _dup_swap_rot},
+        {"spsc", _spsc},
+        {"mpmc-try", _mpmc_try},
+        {"mpmc-blocking", _mpmc_blocking},
+    };
+    long ops = argc > 1 ? atol(argv[1]) : BENCH_DEFAULT_OPS;
+    if (ops <= 0) {
+        fprintf(stderr, "usage: %s [operations per case]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%-16s %9s %13s %14s\n", "case", "ns/op", "reallocs/Mop", "peak RSS KiB");
+    for (size_t b = 0; b < sizeof(benches) / sizeof(benches[0]); b++) {
+        if (_bench_run(&benches[b], ops)) {
+            fprintf(stderr, "%s: failed\n", benches[b].name);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+/**
+ * Run one benchmark in a child process and print its results
+ *
+ * @param bench The benchmark
+ * @param ops The (approximate) number of operations to time
+ * @return false on success, true on failure
+ */
+static bool _bench_run(const bench_t *bench, long ops)
+{
+    // Anything still buffered would be printed again by the child
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        return true;
+    }
+    if (pid == 0) {
+        bench_result_t result;
+        struct rusage usage;
+        if (bench->run(ops, &result) || getrusage(RUSAGE_SELF, &usage)) {
+            _exit(1);
+        }
+        printf("%-16s %9.2f %13.2f %14ld\n", bench->name, result.seconds * 1e9 / result.ops,
+               (double)result.resizes * 1e6 / result.ops, usage.ru_maxrss);
+        fflush(stdout);
+        _exit(0);
+    }
+
+    int status;
+    if (waitpid(pid, &status, 0) != pid) {
+        return true;
+    }
+    return !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+}
+
+
+/**
+ * Define a benchmark that pushes elements of one size onto a stack and
+ * then pops them all
+ *
+ * @param size The element size in bytes (bytes<size>_t)
+ */
+#define BENCH_PUSH_POP(size)                                                        \
+static bool _push_pop_##size(long ops, bench_result_t *result)                      \
+{                                                                                   \
+    bytes##size##_stack_t *stack;                                                   \
+    bytes##size##_t element;                                                        \
+    unsigned long sum = 0;                                                          \
+    long items = ops / 2 > 0 ? ops / 2 : 1;                                         \
+                                                                                    \
+    if (bytes##size##_stack_init(&stack, BENCH_INITIAL_SIZE, STACK_ALLOW_SHRINK)) { \
+        return true;                                                                \
+    }                                                                               \
+    memset(&element, 0, sizeof(element));                                           \
+    double start = _now();                                                          \
+    for (long i = 0; i < items; i++) {                                              \
+        element.bytes[0] = (unsigned char)i;                                        \
+        if (bytes##size##_stack_push(stack, element)) {                             \
+            bytes##size##_stack_destroy(&stack);                                    \
+            return true;                                                            \
+        }                                                                           \
+    }                                                                               \
+    for (long i = 0; i < items; i++) {                                              \
+        bytes##size##_stack_pop(stack, &element);                                   \
+        sum += element.bytes[0];                                                    \
+    }                                                                               \
+    result->seconds = _now() - start;                                               \
+    result->ops = 2.0 * (double)items;                                              \
+    result->resizes = bytes##size##_stack_get_num_resizes(stack);                   \
+    sink = sum;                                                                     \
+    bytes##size##_stack_destroy(&stack);                                            \
+    return false;                                                                   \
+}
+
+BENCH_PUSH_POP(4)
+BENCH_PUSH_POP(16)
+BENCH_PUSH_POP(64)
+BENCH_PUSH_POP(256)
+
+
+/**
+ * Repeatedly fill a stack with BENCH_DRAIN_DEPTH elements and pop them all
+ *
+ * @param ops The (approximate) number of operations to time
+ * @param result Where to store the results
+ * @param allow_shrink STACK_ALLOW_SHRINK or STACK_NO_SHRINK
+ * @return false on success, true on memory allocation failure
+ */
+static bool _drain(long ops, bench_result_t *result, bool allow_shrink)
+{
+    long_stack_t *stack;
+    long element = 0;
+    unsigned long sum = 0;
+    long cycles = ops / (2 * BENCH_DRAIN_DEPTH) > 0 ? ops / (2 * BENCH_DRAIN_DEPTH) : 1;
+
+    if (long_stack_init(&stack, BENCH_INITIAL_SIZE, allow_shrink)) {
+        return true;
+    }
+    double start = _now();
+    for (long c = 0; c < cycles; c++) {
+        for (long i = 0; i < BENCH_DRAIN_DEPTH; i++) {
+            if (long_stack_push(stack, i)) {
+                long_stack_destroy(&stack);
+                return true;
+            }
+        }
+        for (long i = 0; i < BENCH_DRAIN_DEPTH; i++) {
+            long_stack_pop(stack, &element);
+            sum += (unsigned long)element;
+        }
+    }
+    result->seconds = _now() - start;
+    result->ops = 2.0 * BENCH_DRAIN_DEPTH * (double)cycles;
+    result->resizes = long_stack_get_num_resizes(stack);
+    sink = sum;
+    long_stack_destroy(&stack);
+    return false;
+}
+
+
+/**
+ * Drain benchmark on a stack that may shrink
+ *
+ * @param ops The (approximate) number of operations to time
+ * @param result Where to store the results
+ * @return false on success, true on memory allocation failure
+ */
+static bool _drain_shrink(long ops, bench_result_t *result)
+{
+    return _drain(ops, result, STACK_ALLOW_SHRINK);
+}
+
+
+/**
+ * Drain benchmark on a stack that never shrinks
+ *
+ * @param ops The (approximate) number of operations to time
+ * @param result Where to store the results
+ * @return false on success, true on memory allocation failure
+ */
+static bool _drain_noshrink(long ops, bench_result_t *result)
+{
+    return _drain(ops, result, STACK_NO_SHRINK);
+}
+
+
+/**
+ * Grow a stack's array from BENCH_EDGE_DEPTH to 2 * BENCH_EDGE_DEPTH
+ * elements, then repeatedly pop down to just below the point where the
+ * larger array is shrunk and push back up to one past the point where the
+ * smaller array is grown. With shrinking allowed, every cycle shrinks and
+ * grows the array once; without it, the array never changes.
+ *
+ * @param ops The (approximate) number of operations to time
+ * @param result Where to store the results
+ * @param allow_shrink STACK_ALLOW_SHRINK or STACK_NO_SHRINK
+ * @return false on success, true on memory allocation failure
+ */
+static bool _edge(long ops, bench_result_t *result, bool allow_shrink)
+{
+    long_stack_t *stack;
+    long element = 0;
+    unsigned long sum = 0;
+    // The large array is shrunk once fewer than its shrink threshold
+    // (low + 1) items are left; the small one grows at high items
+    const long high = BENCH_EDGE_DEPTH + 1;
+    const long low = (long)(2 * BENCH_EDGE_DEPTH * (STACK_DEFAULT_LOAD_FACTOR - STACK_DEFAULT_MAX_NEGATIVE_LOAD_FACTOR_VARIANCE));
+    long cycles = ops / (2 * (high - low)) > 0 ? ops / (2 * (high - low)) : 1;
+
+    if (long_stack_init(&stack, BENCH_INITIAL_SIZE, allow_shrink)) {
+        return true;
+    }
+    for (long i = 0; i < high; i++) {
+        if (long_stack_push(stack, i)) {
+            long_stack_destroy(&stack);
+            return true;
+        }
+    }
+    size_t prefill_resizes = long_stack_get_num_resizes(stack);
+    double start = _now();
+    for (long c = 0; c < cycles; c++) {
+        for (long i = high; i > low; i--) {
+            long_stack_pop(stack, &element);
+            sum += (unsigned long)element;
+        }
+        for (long i = low; i < high; i++) {
+            if (long_stack_push(stack, i)) {
+                long_stack_destroy(&stack);
+                return true;
+            }
+        }
+    }
+    result->seconds = _now() - start;
+    result->ops = 2.0 * (double)(high - low) * (double)cycles;
+    result->resizes = long_stack_get_num_resizes(stack) - prefill_resizes;
+    sink = sum;
+    long_stack_destroy(&stack);
+    return false;
+}
+
+
+/**
+ * Edge benchmark on a stack that may shrink
+ *
+ * @param ops The (approximate) number of operations to time
+ * @param result Where to store the results
+ * @return false on success, true on memory allocation failure
+ */
+static bool _edge_shrink(long ops, bench_result_t *result)
+{
+    return _edge(ops, result, STACK_ALLOW_SHRINK);
+}
+
+
+/**
+ * Edge benchmark on a stack that never shrinks
+ *
+ * @param ops The (approximate) number of operations to time
+ * @param result Where to store the results
+ * @return false on success, true on memory allocation failure
+ */
+static bool _edge_noshrink(long ops, bench_result_t *result)
+{
+    return _edge(ops, result, STACK_NO_SHRINK);
+}
+
+
+/**
+ * Repeatedly dup(), swap(), rot() and drop() on a 3 element stack
+ *
+ * @param ops The (approximate) number of operations to time
+ * @param result Where to store the results
+ * @return false on success, true on failure
+ */
+static bool _dup_swap_rot(long ops, bench_result_t *result)
+{
+    long_stack_t *stack;
+    long element = 0;
+    long rounds = ops / 4 > 0 ? ops / 4 : 1;
+    bool error = false;
+
+    if (long_stack_init(&stack, BENCH_INITIAL_SIZE, STACK_ALLOW_SHRINK)) {
+        return true;
+    }
+    for (long i = 0; i < 3; i++) {
+        error |= long_stack_push(stack, i);
+    }
+    double start = _now();
+    for (long i = 0; i < rounds && !error; i++) {
+        error |= long_stack_dup(stack);
+        error |= long_stack_swap(stack);
+        error |= long_stack_rot(stack);
+        error |= long_stack_drop(stack);
+    }
+    result->seconds = _now() - start;
+    result->ops = 4.0 * (double)rounds;
+    result->resizes = long_stack_get_num_resizes(stack);
+    error |= long_stack_peek(stack, &element);
+    sink = (unsigned long)element;
+    long_stack_destroy(&stack);
+    return error;
+}
+
+
+/**
+ * Repeatedly enqueue BENCH_QUEUE_BATCH elements on an SPSC queue and
+ * dequeue them
+ *
+ * @param ops The (approximate) number of operations to time
+ * @param result Where to store the results
+ * @return false on success, true on failure
+ */
+static bool _spsc(long ops, bench_result_t *result)
+{
+    long_spsc_queue_t *queue;
+    long element = 0;
+    unsigned long sum = 0;
+    long cycles = ops / (2 * BENCH_QUEUE_BATCH) > 0 ? ops / (2 * BENCH_QUEUE_BATCH) : 1;
+    bool error = false;
+
+    if (long_spsc_queue_init(&queue, BENCH_QUEUE_CAPACITY)) {
+        return true;
+    }
+    double start = _now();
+    for (long c = 0; c < cycles && !error; c++) {
+        for (long i = 0; i < BENCH_QUEUE_BATCH; i++) {
+            error |= long_spsc_queue_enqueue(queue, i);
+        }
+        for (long i = 0; i < BENCH_QUEUE_BATCH; i++) {
+            error |= long_spsc_queue_dequeue(queue, &element);
+            sum += (unsigned long)element;
+        }
+    }
+    result->seconds = _now() - start;
+    result->ops = 2.0 * BENCH_QUEUE_BATCH * (double)cycles;
+    result->resizes = 0;
+    sink = sum;
+    long_spsc_queue_destroy(&queue);
+    return error;
+}
+
+
+/**
+ * Repeatedly enqueue BENCH_QUEUE_BATCH elements on an MPMC queue and
+ * dequeue them
+ *
+ * @param ops The (approximate) number of operations to time
+ * @param result Where to store the results
+ * @param blocking Create a blocking queue and use enqueue_wait() and
+ *                 dequeue_wait() instead of enqueue() and dequeue()
+ * @return false on success, true on failure
+ */
+static bool _mpmc(long ops, bench_result_t *result, bool blocking)
+{
+    long_mpmc_queue_t *queue;
+    long element = 0;
+    unsigned long sum = 0;
+    long cycles = ops / (2 * BENCH_QUEUE_BATCH) > 0 ? ops / (2 * BENCH_QUEUE_BATCH) : 1;
+    bool error = false;
+
+    if (long_mpmc_queue_init(&queue, BENCH_QUEUE_CAPACITY, blocking)) {
+        return true;
+    }
+    double start = _now();
+    for (long c = 0; c < cycles && !error; c++) {
+        for (long i = 0; i < BENCH_QUEUE_BATCH; i++) {
+            error |= blocking ? long_mpmc_queue_enqueue_wait(queue, i)
+                              : long_mpmc_queue_enqueue(queue, i);
+        }
+        for (long i = 0; i < BENCH_QUEUE_BATCH; i++) {
+            error |= blocking ? long_mpmc_queue_dequeue_wait(queue, &element)
+                              : long_mpmc_queue_dequeue(queue, &element);
+            sum += (unsigned long)element;
+        }
+    }
+    result->seconds = _now() - start;
+    result->ops = 2.0 * BENCH_QUEUE_BATCH * (double)cycles;
+    result->resizes = 0;
+    sink = sum;
+    long_mpmc_queue_destroy(&queue);
+    return error;
+}
+
+
+/**
+ * Batch benchmark on a non-blocking MPMC queue
+ *
+ * @param ops The (approximate) number of operations to time
+ * @param result Where to store the results
+ * @return false on success, true on failure
+ */
+static bool _mpmc_try(long ops, bench_result_t *result)
+{
+    return _mpmc(ops, result, false);
+}
+
+
+/**
+ * Batch benchmark on a blocking MPMC queue
+ *
+ * @param ops The (approximate) number of operations to time
+ * @param result Where to store the results
+ * @return false on success, true on failure
+ */
+static bool _mpmc_blocking(long ops, bench_result_t *result)
+{
+    return _mpmc(ops, result, true);
+}
+
+
+/**
+ * Read the monotonic clock
+ *
+ * @return The time in seconds
+ */
+static double _now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
@@ -13,18 +13,49 @@
  * 2023-06-24: Correct peeki with index=0 error check
  * 2023-07-02: Remove index<0 check in peeki since
  *             size_t is unsigned
+ * 2026-10-18: Grow only when the array is full and shrink based on a
+ *             precomputed item count instead of a float load factor.
+ *             Add push_n(), pop_n() and peek_n(). Handle stacks with an
+ *             initial size of 0
+ * 2026-10-18: Add small-buffer stacks (__stack_init_inline())
+ * 2026-10-18: Add address-space-reserved stacks (__stack_init_reserved())
+ * 2026-10-18: Add top_ptr(), at_ptr() and push_emplace()
+ * 2026-10-18: Fix dup() failing on non-empty stacks and rot() accepting
+ *             stacks with only two items
+ * 2026-10-18: Add mark() and release()
+ * 2026-10-19: Count array resizes (__stack_get_num_resizes())
+ * 2026-10-19: Only count resizes that allocate, free or commit memory
+ *             (not clear() on a stack already at its initial size)
  * 
  * USAGE: see stack.h
  */
 
+#if defined(__unix__) || defined(__APPLE__)
+# ifndef _DEFAULT_SOURCE
+#  define _DEFAULT_SOURCE // MAP_ANONYMOUS, madvise() in strict C modes
+# endif
+# include <sys/mman.h>
+# include <unistd.h> // sysconf()
+# define STACK_HAVE_RESERVE
+# if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#  define MAP_ANONYMOUS MAP_ANON
+# endif
+# ifndef MAP_NORESERVE
+#  define MAP_NORESERVE 0
+# endif
+#endif
+
 #define __STACK_STACK_C
 #include "stack.h"
 #undef __STACK_STACK_C
 
 // Helper functions
-static inline float _stack_get_load_factor(_stack_t *stack);
-static bool _stack_double_stack(_stack_t *stack, size_t element_size);
-static bool _stack_half_stack(_stack_t *stack, size_t element_size);
+static inline size_t _stack_shrink_threshold(_stack_t *stack, size_t array_size);
+static bool _stack_resize(_stack_t *stack, size_t element_size, size_t new_size);
+#ifdef STACK_HAVE_RESERVE
+static inline size_t _stack_page_round(size_t bytes);
+static bool _stack_commit(_stack_t *stack, size_t element_size, size_t new_size);
+#endif
 
 
 /**
@@ -45,17 +76,115 @@ bool __stack_init(_stack_t **stack, size_t element_size, size_t initial_size, bo
     if (!*stack) {
         return true;
     }
-    (*stack)->table = malloc(sizeof(char) * element_size * initial_size);
-    if (!((*stack)->table)) {
+    (*stack)->table = NULL;
+    if (initial_size) {
+        (*stack)->table = malloc(sizeof(char) * element_size * initial_size);
+        if (!((*stack)->table)) {
+            free(*stack);
+            return true;
+        }
+    }
+    (*stack)->current_load_factor = 0;
+    (*stack)->number_of_items_in_table = 0;
+    (*stack)->array_size = initial_size;
+    (*stack)->min_array_size = initial_size;
+    (*stack)->allow_shrink = allow_shrink;
+    (*stack)->shrink_threshold = _stack_shrink_threshold(*stack, initial_size);
+    (*stack)->inline_table = NULL;
+    (*stack)->reserved_bytes = 0;
+    (*stack)->number_of_resizes = 0;
+    return false;
+}
+
+
+/**
+ * Initialize a stack that is not heap-allocated and that starts out using
+ * a caller-provided buffer as its array. The stack only allocates an array
+ * on the heap once it holds more than capacity elements, and moves back
+ * into the buffer when it shrinks back down to capacity.
+ * @note Free with __stack_destroy_inline(), not __stack_destroy()
+ * @note The buffer must stay valid for as long as the stack is in use
+ * 
+ * @param *stack The stack to initialize
+ * @param *buffer Space for capacity elements
+ * @param capacity Number of elements that fit in buffer (must be > 0)
+ * @param allow_shrink Set to true to allow the stack's internal array
+ *                     to shrink automatically if enough items are popped
+ *                     off. Set to false to disable shrinking (it will
+ *                     only grow).
+ */
+void __stack_init_inline(_stack_t *stack, void *buffer, size_t capacity, bool allow_shrink)
+{
+    stack->table = buffer;
+    stack->inline_table = buffer;
+    stack->current_load_factor = 0;
+    stack->number_of_items_in_table = 0;
+    stack->array_size = capacity;
+    stack->min_array_size = capacity;
+    stack->allow_shrink = allow_shrink;
+    stack->shrink_threshold = _stack_shrink_threshold(stack, capacity);
+    stack->reserved_bytes = 0;
+    stack->number_of_resizes = 0;
+}
+
+
+/**
+ * Heap-allocate a new stack datastructure whose array is a reserved range
+ * of address space with room for max_size elements. Pages are committed as
+ * the stack grows and released as it shrinks, but the array never moves.
+ * @note Only available on POSIX systems (fails elsewhere)
+ * 
+ * @param **stack Pointer to the stack
+ * @param element_size [internal use] Size of element stored in stack
+ * @param initial_size Number of elements to store initially
+ * @param max_size Maximum number of elements the stack can hold
+ * @param allow_shrink Set to true to allow the stack's internal array
+ *                     to shrink automatically if enough items are popped
+ *                     off. Set to false to disable shrinking (it will
+ *                     only grow).
+ * @return false on success, true on failure (memory allocation failure,
+ *         initial_size > max_size or max_size of 0)
+ */
+bool __stack_init_reserved(_stack_t **stack, size_t element_size, size_t initial_size, size_t max_size, bool allow_shrink)
+{
+#ifdef STACK_HAVE_RESERVE
+    if (max_size == 0 || initial_size > max_size || max_size > ((size_t)-1 / 2) / element_size) {
+        return true;
+    }
+    *stack = malloc(sizeof(**stack));
+    if (!*stack) {
+        return true;
+    }
+    size_t reserved_bytes = _stack_page_round(element_size * max_size);
+    void *table = mmap(NULL, reserved_bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (table == MAP_FAILED) {
         free(*stack);
         return true;
     }
+    (*stack)->table = table;
+    (*stack)->inline_table = NULL;
+    (*stack)->reserved_bytes = reserved_bytes;
     (*stack)->current_load_factor = 0;
     (*stack)->number_of_items_in_table = 0;
-    (*stack)->array_size = initial_size;
+    (*stack)->array_size = 0;
     (*stack)->min_array_size = initial_size;
     (*stack)->allow_shrink = allow_shrink;
+    if (_stack_commit(*stack, element_size, initial_size)) {
+        munmap(table, reserved_bytes);
+        free(*stack);
+        return true;
+    }
+    // Like init(), the initial array does not count as a resize
+    (*stack)->number_of_resizes = 0;
     return false;
+#else
+    (void)stack;
+    (void)element_size;
+    (void)initial_size;
+    (void)max_size;
+    (void)allow_shrink;
+    return true;
+#endif
 }
 
 
@@ -69,15 +198,9 @@ bool __stack_init(_stack_t **stack, size_t element_size, size_t initial_size, bo
  */
 bool __stack_clear(_stack_t *stack, size_t element_size)
 {
-    char *tmp = realloc(stack->table, sizeof(char) * element_size * (stack->min_array_size));
-    if (!tmp) {
-        return true;
-    }
-    stack->table = tmp;
     stack->current_load_factor = 0;
     stack->number_of_items_in_table = 0;
-    stack->array_size = stack->min_array_size;
-    return false;
+    return _stack_resize(stack, element_size, stack->min_array_size);
 }
 
 
@@ -108,11 +231,38 @@ void __stack_destroy(_stack_t **stack)
     if (!stack || !*stack) {
         return;
     }
+#ifdef STACK_HAVE_RESERVE
+    if ((*stack)->reserved_bytes) {
+        munmap((*stack)->table, (*stack)->reserved_bytes);
+        free(*stack);
+        return;
+    }
+#endif
     free((*stack)->table);
     free(*stack);
 }
 
 
+/**
+ * Free the heap array (if any) of a stack set up with __stack_init_inline().
+ * The stack can be reused after calling __stack_init_inline() again.
+ * 
+ * @param *stack The stack to free the array of
+ */
+void __stack_destroy_inline(_stack_t *stack)
+{
+    if (!stack) {
+        return;
+    }
+    if (stack->table != stack->inline_table) {
+        free(stack->table);
+    }
+    stack->table = stack->inline_table;
+    stack->number_of_items_in_table = 0;
+    stack->array_size = stack->min_array_size;
+}
+
+
 /**
  * Get the element on the top of the stack
  * 
@@ -152,6 +302,63 @@ bool __stack_peeki(_stack_t *stack, size_t element_size, void *element, size_t i
 }
 
 
+/**
+ * Get a pointer to the element on the top of the stack
+ * @note The pointer is invalidated by any operation that may
+ *       resize the stack (see stack.h)
+ * 
+ * @param *stack The stack to look at
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @return A pointer to the top element, NULL on empty stack
+ */
+void *__stack_top_ptr(_stack_t *stack, size_t element_size)
+{
+    return __stack_at_ptr(stack, element_size, 0);
+}
+
+
+/**
+ * Get a pointer to the element at an index relative to the top of the stack
+ * @note The pointer is invalidated by any operation that may
+ *       resize the stack (see stack.h)
+ * 
+ * @param *stack The stack to look at
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @param index The index, relative to the top of the stack, of the element.
+ *              If 0 is given, this behaves the same as __stack_top_ptr()
+ * @return A pointer to the element, NULL on empty stack or index
+ *         outside of stack size
+ */
+void *__stack_at_ptr(_stack_t *stack, size_t element_size, size_t index)
+{
+    if (!stack || index >= stack->number_of_items_in_table) {
+        return NULL;
+    }
+    return stack->table + (element_size * (stack->number_of_items_in_table - 1 - index));
+}
+
+
+/**
+ * Push a new, uninitialized element onto the top of the stack and return
+ * its address so that it can be constructed in place
+ * @note The pointer is invalidated by any operation that may
+ *       resize the stack (see stack.h)
+ * 
+ * @param *stack The stack to push onto
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @return A pointer to the new top element, NULL on failure (memory
+ *         allocation failure; nothing is pushed)
+ */
+void *__stack_push_emplace(_stack_t *stack, size_t element_size)
+{
+    if (stack->number_of_items_in_table == stack->array_size &&
+        __stack_grow(stack, element_size, stack->number_of_items_in_table + 1)) {
+        return NULL;
+    }
+    return stack->table + (element_size * (stack->number_of_items_in_table)++);
+}
+
+
 /**
  * Remove the top element on the stack and return its value
  * 
@@ -169,7 +376,10 @@ bool __stack_pop(_stack_t *stack, size_t element_size, void *element)
 
     --(stack->number_of_items_in_table);
     
-    return _stack_half_stack(stack, element_size);
+    if (stack->number_of_items_in_table < stack->shrink_threshold) {
+        return __stack_shrink(stack, element_size);
+    }
+    return false;
 }
 
 
@@ -188,7 +398,10 @@ bool __stack_drop(_stack_t *stack, size_t element_size)
 
     --(stack->number_of_items_in_table);
     
-    return _stack_half_stack(stack, element_size);
+    if (stack->number_of_items_in_table < stack->shrink_threshold) {
+        return __stack_shrink(stack, element_size);
+    }
+    return false;
 }
 
 
@@ -202,7 +415,7 @@ bool __stack_drop(_stack_t *stack, size_t element_size)
 bool __stack_dup(_stack_t *stack, size_t element_size)
 {
     char element[element_size];
-    if (!__stack_peek(stack, element_size, &element)) {
+    if (__stack_peek(stack, element_size, &element)) {
         return true;
     }
     return __stack_push(stack, element_size, (void *)&element);
@@ -245,7 +458,7 @@ bool __stack_swap(_stack_t *stack, size_t element_size)
  */
 bool __stack_rot(_stack_t *stack, size_t element_size)
 {
-    if (stack->number_of_items_in_table < 2) {
+    if (stack->number_of_items_in_table < 3) {
         return true;
     }
     char tmp_element[element_size];
@@ -276,13 +489,93 @@ bool __stack_rot(_stack_t *stack, size_t element_size)
  */
 bool __stack_push(_stack_t *stack, size_t element_size, void *element)
 {
-    stack->number_of_items_in_table += 1;
-    if (_stack_double_stack(stack, element_size)) {
-        stack->number_of_items_in_table -= 1;
+    if (stack->number_of_items_in_table == stack->array_size &&
+        __stack_grow(stack, element_size, stack->number_of_items_in_table + 1)) {
         return true;
     }
-    memcpy(stack->table + (sizeof(char) * element_size * (stack->number_of_items_in_table - 1)),
+    memcpy(stack->table + (sizeof(char) * element_size * stack->number_of_items_in_table),
            element, element_size);
+    stack->number_of_items_in_table += 1;
+    return false;
+}
+
+
+/**
+ * Push a block of items onto the stack with a single copy.
+ * elements[n - 1] ends up on the top of the stack.
+ * 
+ * @param *stack The stack to push the items onto
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @param *elements The n items to push
+ * @param n The number of items to push
+ * @return false on success, true on failure (memory allocation failure
+ *         or null *elements pointer)
+ */
+bool __stack_push_n(_stack_t *stack, size_t element_size, const void *elements, size_t n)
+{
+    if (n == 0) {
+        return false;
+    }
+    if (!elements || n > (size_t)-1 - stack->number_of_items_in_table) {
+        return true;
+    }
+    if (stack->number_of_items_in_table + n > stack->array_size &&
+        __stack_grow(stack, element_size, stack->number_of_items_in_table + n)) {
+        return true;
+    }
+    memcpy(stack->table + (sizeof(char) * element_size * stack->number_of_items_in_table),
+           elements, element_size * n);
+    stack->number_of_items_in_table += n;
+    return false;
+}
+
+
+/**
+ * Remove the top n items from the stack with a single copy.
+ * The order of the items is kept: elements[n - 1] receives the
+ * item that was on the top of the stack.
+ * 
+ * @param *stack The stack to remove the items from
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @param *elements A pointer to the location to store the n pop'd values
+ * @param n The number of items to pop
+ * @return false on success, true on memory error or fewer than n items
+ *         in the stack or null *elements pointer (nothing is pop'd)
+ */
+bool __stack_pop_n(_stack_t *stack, size_t element_size, void *elements, size_t n)
+{
+    if (__stack_peek_n(stack, element_size, elements, n)) {
+        return true;
+    }
+    stack->number_of_items_in_table -= n;
+
+    if (stack->number_of_items_in_table < stack->shrink_threshold) {
+        return __stack_shrink(stack, element_size);
+    }
+    return false;
+}
+
+
+/**
+ * Get the top n items of the stack with a single copy.
+ * elements[n - 1] receives the item on the top of the stack.
+ * 
+ * @param *stack The stack to look at
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @param *elements A pointer to the location to store the n peek'd values
+ * @param n The number of items to peek
+ * @return false on success, true on fewer than n items in the stack or
+ *         null *elements pointer
+ */
+bool __stack_peek_n(_stack_t *stack, size_t element_size, void *elements, size_t n)
+{
+    if (!stack || (!elements && n) || n > stack->number_of_items_in_table) {
+        return true;
+    }
+    if (n) {
+        memcpy(elements, stack->table + (sizeof(char) * element_size * (stack->number_of_items_in_table - n)),
+               element_size * n);
+    }
     return false;
 }
 
@@ -304,59 +597,251 @@ size_t __stack_get_num_elements(_stack_t *stack)
 
 
 /**
- * Get the current stack's load factor
+ * Returns the number of times the stack's internal array has been resized
+ * (memory allocated, freed or committed) since the stack was initialized
+ * 
+ * @param stack The stack to check
+ * @return The number of resizes (0 if stack is NULL)
+ */
+size_t __stack_get_num_resizes(_stack_t *stack)
+{
+    if (stack != NULL)
+    {
+        return stack->number_of_resizes;
+    }
+    return 0;
+}
+
+
+/**
+ * Get a mark for the current top of the stack, to be passed to
+ * __stack_release() later
  * 
- * @param stack The stack to check its load factor
- * @return The provided stack's load factor
+ * @param stack The stack to mark
+ * @return The mark (the current number of elements, 0 if stack is NULL)
  */
-static float _stack_get_load_factor(_stack_t *stack)
+stack_mark_t __stack_mark(_stack_t *stack)
 {
-    return ((float)(stack->number_of_items_in_table)) / ((float)(stack->array_size));
+    return __stack_get_num_elements(stack);
 }
 
 
 /**
- * Doubles the size of the array for the specified stack if the
- * stack's load factor is large enough
+ * Remove every element pushed since a mark was taken in O(1). If the
+ * stack may shrink, its array is shrunk at most once.
+ * 
+ * @param *stack The stack to truncate
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @param mark A mark returned by __stack_mark()
+ * @return false on success, true on memory error or if the stack holds
+ *         fewer elements than when the mark was taken (nothing is removed)
+ */
+bool __stack_release(_stack_t *stack, size_t element_size, stack_mark_t mark)
+{
+    if (!stack || mark > stack->number_of_items_in_table) {
+        return true;
+    }
+    stack->number_of_items_in_table = mark;
+
+    if (stack->number_of_items_in_table < stack->shrink_threshold) {
+        return __stack_shrink(stack, element_size);
+    }
+    return false;
+}
+
+
+/**
+ * Grow the internal array so that it can hold at least min_size items.
+ * The array size is doubled (as many times as needed).
+ * 
+ * @note Called by the inlined push() when the array is full
  * 
- * @param stack The stack to be doubled in size
+ * @param stack The stack to grow
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @param min_size The number of items the array must be able to hold
  * @return false on successful operation, true on memory allocation error
  */
-static bool _stack_double_stack(_stack_t *stack, size_t element_size)
+bool __stack_grow(_stack_t *stack, size_t element_size, size_t min_size)
 {
-    if (_stack_get_load_factor(stack) < STACK_DEFAULT_LOAD_FACTOR - STACK_DEFAULT_MAX_POSITIVE_LOAD_FACTOR_VARIANCE) {
+    size_t new_size = stack->array_size ? stack->array_size : 1;
+    while (new_size < min_size) {
+        if (new_size > (size_t)-1 / 2) {
+            new_size = min_size;
+            break;
+        }
+        new_size *= 2;
+    }
+    if (stack->reserved_bytes && new_size > stack->reserved_bytes / element_size) {
+        // Doubling would overshoot the reservation, so fill it instead
+        new_size = stack->reserved_bytes / element_size;
+        if (new_size < min_size) {
+            return true;
+        }
+    }
+    if (new_size <= stack->array_size) {
         return false;
     }
-    char *tmp  = realloc(stack->table, sizeof(char) * element_size * stack->array_size * 2);
-    if (!tmp) {
+    if (new_size > (size_t)-1 / element_size) {
         return true;
     }
-    stack->table = tmp;
-    stack->array_size *= 2;
-    return false;
+    return _stack_resize(stack, element_size, new_size);
 }
 
 
 /**
- * Halve the size of the array for holding elements in the specified HashTable
+ * Shrink the internal array with a single reallocation, halving its size
+ * for as long as the stack's item count is below the shrink threshold
  * 
- * @param table The table to be halved
+ * @note Called by the inlined pop() once the item count drops below
+ *       stack->shrink_threshold
+ * 
+ * @param stack The stack to shrink
+ * @param element_size [internal use] The size of an element stored in the stack
  * @return false on successful operation, true on memory allocation error
  */
-static bool _stack_half_stack(_stack_t *stack, size_t element_size)
+bool __stack_shrink(_stack_t *stack, size_t element_size)
+{
+    size_t new_size = stack->array_size;
+    while (stack->number_of_items_in_table < _stack_shrink_threshold(stack, new_size)) {
+        new_size /= 2;
+    }
+    if (new_size == stack->array_size) {
+        return false;
+    }
+    return _stack_resize(stack, element_size, new_size);
+}
+
+
+/**
+ * Compute the item count below which an array of the given size is halved.
+ * An array is halved when its load factor would be at or below
+ * STACK_DEFAULT_LOAD_FACTOR - STACK_DEFAULT_MAX_NEGATIVE_LOAD_FACTOR_VARIANCE
+ * 
+ * @param stack The stack that the array belongs to
+ * @param array_size The size of the array
+ * @return The threshold (0 if the array may not be shrunk)
+ */
+static size_t _stack_shrink_threshold(_stack_t *stack, size_t array_size)
 {
     if (!stack->allow_shrink ||
-        stack->array_size < 2 * stack->min_array_size ||
-        _stack_get_load_factor(stack) > STACK_DEFAULT_LOAD_FACTOR - STACK_DEFAULT_MAX_NEGATIVE_LOAD_FACTOR_VARIANCE) {
+        array_size < 2 ||
+        array_size < 2 * stack->min_array_size) {
         
-        return false;
+        return 0;
     }
-    char *tmp  = realloc(stack->table, sizeof(char) * element_size * stack->array_size / 2);
-    if (!tmp) {
-        return true;
+    return (size_t)(array_size * (STACK_DEFAULT_LOAD_FACTOR - STACK_DEFAULT_MAX_NEGATIVE_LOAD_FACTOR_VARIANCE)) + 1;
+}
+
+
+/**
+ * Reallocate the internal array of a stack
+ * 
+ * @param stack The stack to resize
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @param new_size The new number of elements in the array
+ * @return false on successful operation, true on memory allocation error
+ */
+static bool _stack_resize(_stack_t *stack, size_t element_size, size_t new_size)
+{
+#ifdef STACK_HAVE_RESERVE
+    if (stack->reserved_bytes) {
+        return _stack_commit(stack, element_size, new_size);
+    }
+#endif
+    // Only count the resize if memory was actually allocated or freed
+    bool resized = true;
+    if (stack->inline_table && new_size <= stack->min_array_size) {
+        // Small enough to move back into the small buffer
+        if (stack->table != stack->inline_table) {
+            memcpy(stack->inline_table, stack->table, element_size * stack->number_of_items_in_table);
+            free(stack->table);
+            stack->table = stack->inline_table;
+        }
+        else {
+            resized = false;
+        }
+        new_size = stack->min_array_size;
+    }
+    else if (stack->inline_table && stack->table == stack->inline_table) {
+        // Spill from the small buffer to the heap
+        char *tmp = malloc(sizeof(char) * element_size * new_size);
+        if (!tmp) {
+            return true;
+        }
+        memcpy(tmp, stack->table, element_size * stack->number_of_items_in_table);
+        stack->table = tmp;
+    }
+    else if (new_size == 0) {
+        resized = (stack->table != NULL);
+        free(stack->table);
+        stack->table = NULL;
+    }
+    else if (stack->table && new_size == stack->array_size) {
+        resized = false;
+    }
+    else {
+        char *tmp = realloc(stack->table, sizeof(char) * element_size * new_size);
+        if (!tmp) {
+            return true;
+        }
+        stack->table = tmp;
+    }
+    stack->array_size = new_size;
+    stack->shrink_threshold = _stack_shrink_threshold(stack, new_size);
+    if (resized) {
+        ++(stack->number_of_resizes);
     }
-    stack->table = tmp;
-    stack->array_size /= 2;
     return false;
 }
 
+
+#ifdef STACK_HAVE_RESERVE
+/**
+ * Round a number of bytes up to a whole number of pages
+ * 
+ * @param bytes The number of bytes
+ * @return The rounded number of bytes
+ */
+static size_t _stack_page_round(size_t bytes)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    return (bytes + page - 1) / page * page;
+}
+
+
+/**
+ * Resize the array of a stack created by __stack_init_reserved() in place.
+ * Growing makes the pages up to new_size accessible. Shrinking hands the
+ * pages past new_size back to the OS and makes them inaccessible again.
+ * 
+ * @param stack The stack to resize
+ * @param element_size [internal use] The size of an element stored in the stack
+ * @param new_size The new number of elements in the array
+ * @return false on successful operation, true on memory allocation error
+ *         (or if new_size does not fit in the reservation)
+ */
+static bool _stack_commit(_stack_t *stack, size_t element_size, size_t new_size)
+{
+    if (new_size > stack->reserved_bytes / element_size) {
+        return true;
+    }
+    size_t old_bytes = _stack_page_round(element_size * stack->array_size);
+    size_t new_bytes = _stack_page_round(element_size * new_size);
+
+    if (new_bytes > old_bytes) {
+        if (mprotect(stack->table + old_bytes, new_bytes - old_bytes, PROT_READ | PROT_WRITE)) {
+            return true;
+        }
+    }
+    else if (new_bytes < old_bytes) {
+        madvise(stack->table + new_bytes, old_bytes - new_bytes, MADV_DONTNEED);
+        mprotect(stack->table + new_bytes, old_bytes - new_bytes, PROT_NONE);
+    }
+    stack->array_size = new_size;
+    stack->shrink_threshold = _stack_shrink_threshold(stack, new_size);
+    if (new_bytes != old_bytes) {
+        ++(stack->number_of_resizes);
+    }
+    return false;
+}
+#endif
@@ -12,12 +12,63 @@
  *             macros to end of header.
  * 2023-04-01: Add init param to prevent automatic
  *             shrinking of the internal array
+ * 2026-10-18: Inline push() and pop() in the generic wrappers
+ *             (growth/shrinking is outlined in __stack_grow() and
+ *             __stack_shrink()). Add push_n(), pop_n() and peek_n()
+ * 2026-10-18: Add small-buffer stacks (STACK_INLINE_CAP)
+ * 2026-10-18: Add address-space-reserved stacks (init_reserved())
+ * 2026-10-18: Add top_ptr(), at_ptr() and push_emplace()
+ * 2026-10-18: Add STACK_TYPED mode
+ * 2026-10-18: Add mark() and release()
+ * 2026-10-19: Count array resizes (get_num_resizes())
  * 
  * USAGE:
  * Define STACK_DATA_T as the data type to be stored in the stack structure.
  * Define STACK_DATA_NAME as the data name for the associated function calls.
  * **NOTE**: Do not enclose the above macros in parens! For example, if the 
  *           data type is char* , define the macros as char* , not (char*)
+ *
+ * Optionally define STACK_INLINE_CAP as a number of elements N to also get
+ * the small-buffer stack type <name>_istack_t. It can be declared by value
+ * (e.g. as a local variable) and holds up to N elements in itself, only
+ * moving to a heap array once it grows past N elements:
+ *
+ *     int_istack_t s;
+ *     int_stack_t *stack = int_istack_init(&s, STACK_ALLOW_SHRINK);
+ *     int_stack_push(stack, 1);
+ *     ...
+ *     int_istack_destroy(&s); // NOT int_stack_destroy()
+ *
+ * For very large stacks, init_reserved() reserves address space for up to
+ * max_size elements up front (mmap(), POSIX only) and commits pages as the
+ * stack grows. The array never moves, so growing never copies elements,
+ * never needs twice the memory and pointers into the table stay valid.
+ * Shrinking gives the unused pages back to the OS. The stack cannot grow
+ * past max_size elements (rounded up to whole pages).
+ *
+ * top_ptr(), at_ptr() and push_emplace() give direct access to elements in
+ * the internal array instead of copying them in or out. A returned pointer
+ * is invalidated by anything that may resize the array: push(), push_n(),
+ * push_emplace(), dup(), pop(), pop_n(), drop(), release() and clear().
+ * To pop a large element without copying it, use it through top_ptr() and
+ * then drop() it. Stacks created with init_reserved() never move their
+ * array, so there a pointer stays valid until its element is popped.
+ *
+ * Optionally define STACK_TYPED (along with STACK_DATA_T) to have the
+ * generic wrappers for peek(), peeki(), top(), drop(), dup(), swap() and
+ * rot() implemented inline on the typed array instead of forwarding
+ * sizeof(STACK_DATA_T) to the untyped functions. Element moves then
+ * compile to plain loads and stores. push() and pop() are always inlined.
+ *
+ * mark() returns the current stack position and release() truncates the
+ * stack back to a mark in O(1), shrinking the array at most once. This
+ * drops everything pushed since the mark without popping it item by item.
+ *
+ * get_num_resizes() returns how many times the array has been resized
+ * (grown, shrunk, moved between the small buffer and the heap, or pages
+ * committed/released for reserved stacks) since init(). Dividing it by the
+ * number of operations shows how much a workload is paying for resizing,
+ * e.g. when pushes and pops oscillate around a shrink threshold.
  */
 
 #include <stddef.h> // size_t
@@ -38,19 +89,28 @@
 #define STACK_ALLOW_SHRINK true
 #define STACK_NO_SHRINK false
 
+typedef size_t stack_mark_t;
+
 typedef struct _stack_t {
     float current_load_factor;             // Load factor
     size_t number_of_items_in_table;       // Number of actual items currently in the internal array
     size_t array_size;                     // Size of the internal array
     size_t min_array_size;
+    size_t shrink_threshold;               // Shrink once fewer items than this are in the array
     bool allow_shrink;
     char *table;                           // Internal array
+    char *inline_table;                    // Small buffer of min_array_size elements (NULL if none)
+    size_t reserved_bytes;                 // Address space reserved for table (0 if not reserved)
+    size_t number_of_resizes;              // Number of times the array was resized
 } _stack_t;
 
 bool __stack_init(_stack_t **stack, size_t element_size, size_t initial_size, bool allow_shrink);
+void __stack_init_inline(_stack_t *stack, void *buffer, size_t capacity, bool allow_shrink);
+bool __stack_init_reserved(_stack_t **stack, size_t element_size, size_t initial_size, size_t max_size, bool allow_shrink);
 bool __stack_clear(_stack_t *stack, size_t element_size);
 bool __stack_is_empty(_stack_t *stack);
 void __stack_destroy(_stack_t **stack);
+void __stack_destroy_inline(_stack_t *stack);
 bool __stack_peek(_stack_t *stack, size_t element_size, void *element);
 bool __stack_peeki(_stack_t *stack, size_t element_size, void *element, size_t index);
 bool __stack_pop(_stack_t *stack, size_t element_size, void *element);
@@ -59,7 +119,18 @@ bool __stack_dup(_stack_t *stack, size_t element_size);
 bool __stack_swap(_stack_t *stack, size_t element_size);
 bool __stack_rot(_stack_t *stack, size_t element_size);
 bool __stack_push(_stack_t *stack, size_t element_size, void *element);
+void *__stack_top_ptr(_stack_t *stack, size_t element_size);
+void *__stack_at_ptr(_stack_t *stack, size_t element_size, size_t index);
+void *__stack_push_emplace(_stack_t *stack, size_t element_size);
+bool __stack_push_n(_stack_t *stack, size_t element_size, const void *elements, size_t n);
+bool __stack_pop_n(_stack_t *stack, size_t element_size, void *elements, size_t n);
+bool __stack_peek_n(_stack_t *stack, size_t element_size, void *elements, size_t n);
 size_t __stack_get_num_elements(_stack_t *stack);
+size_t __stack_get_num_resizes(_stack_t *stack);
+stack_mark_t __stack_mark(_stack_t *stack);
+bool __stack_release(_stack_t *stack, size_t element_size, stack_mark_t mark);
+bool __stack_grow(_stack_t *stack, size_t element_size, size_t min_size);
+bool __stack_shrink(_stack_t *stack, size_t element_size);
 
 #endif
 
@@ -77,16 +148,50 @@ typedef struct __STACK_T {
     size_t number_of_items_in_table; // Number of actual items currently in the internal array
     size_t array_size;               // Size of the internal array
     size_t min_array_size;
+    size_t shrink_threshold;         // Shrink once fewer items than this are in the array
     bool allow_shrink;
     STACK_DATA_T *table;                   // Internal array
+    STACK_DATA_T *inline_table;            // Small buffer of min_array_size elements (NULL if none)
+    size_t reserved_bytes;                 // Address space reserved for table (0 if not reserved)
+    size_t number_of_resizes;              // Number of times the array was resized
 } __STACK_T;
 
+#ifdef STACK_INLINE_CAP
+# if STACK_INLINE_CAP < 1
+#  error "STACK_INLINE_CAP must be at least 1"
+# endif
+# define __ISTACK_T STACK_GLUE(STACK_DATA_NAME, _istack_t)
+typedef struct __ISTACK_T {
+    __STACK_T stack;
+    STACK_DATA_T inline_table[STACK_INLINE_CAP];
+} __ISTACK_T;
+#endif
+
 // Function prototypes
 static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_init)(__STACK_T **stack, size_t initial_size, bool allow_shrink)
 {
     return __stack_init((_stack_t**)stack, sizeof(STACK_DATA_T), initial_size, allow_shrink);
 }
 
+static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_init_reserved)(__STACK_T **stack, size_t initial_size, size_t max_size, bool allow_shrink)
+{
+    return __stack_init_reserved((_stack_t**)stack, sizeof(STACK_DATA_T), initial_size, max_size, allow_shrink);
+}
+
+#ifdef STACK_INLINE_CAP
+// Returns the stack to use with the other functions (never fails)
+static inline __STACK_T *STACK_GLUE(STACK_DATA_NAME, _istack_init)(__ISTACK_T *istack, bool allow_shrink)
+{
+    __stack_init_inline((_stack_t*)&(istack->stack), (void*)istack->inline_table, STACK_INLINE_CAP, allow_shrink);
+    return &(istack->stack);
+}
+
+static inline void STACK_GLUE(STACK_DATA_NAME, _istack_destroy)(__ISTACK_T *istack)
+{
+    __stack_destroy_inline((_stack_t*)&(istack->stack));
+}
+#endif
+
 static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_clear)(__STACK_T *stack)
 {
     return __stack_clear((_stack_t*)stack, sizeof(STACK_DATA_T));
@@ -102,6 +207,25 @@ static inline void STACK_GLUE(STACK_DATA_NAME, _stack_destroy)(__STACK_T **stack
     __stack_destroy((_stack_t**)stack);
 }
 
+#ifdef STACK_TYPED
+static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_peek)(__STACK_T *stack, STACK_DATA_T *element)
+{
+    if (!element || stack->number_of_items_in_table == 0) {
+        return true;
+    }
+    *element = stack->table[stack->number_of_items_in_table - 1];
+    return false;
+}
+
+static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_peeki)(__STACK_T *stack, STACK_DATA_T *element, size_t index)
+{
+    if (!element || index >= stack->number_of_items_in_table) {
+        return true;
+    }
+    *element = stack->table[stack->number_of_items_in_table - 1 - index];
+    return false;
+}
+#else
 static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_peek)(__STACK_T *stack, STACK_DATA_T *element)
 {
     return __stack_peek((_stack_t*)stack, sizeof(STACK_DATA_T), (void *)element);
@@ -111,18 +235,106 @@ static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_peeki)(__STACK_T *stack, S
 {
     return __stack_peeki((_stack_t*)stack, sizeof(STACK_DATA_T), (void *)element, index);
 }
+#endif
+
+static inline STACK_DATA_T *STACK_GLUE(STACK_DATA_NAME, _stack_top_ptr)(__STACK_T *stack)
+{
+    if (stack->number_of_items_in_table == 0) {
+        return NULL;
+    }
+    return &(stack->table[stack->number_of_items_in_table - 1]);
+}
+
+static inline STACK_DATA_T *STACK_GLUE(STACK_DATA_NAME, _stack_at_ptr)(__STACK_T *stack, size_t index)
+{
+    if (index >= stack->number_of_items_in_table) {
+        return NULL;
+    }
+    return &(stack->table[stack->number_of_items_in_table - 1 - index]);
+}
 
 // Alias for peek
 static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_top)(__STACK_T *stack, STACK_DATA_T *element)
 {
-    return __stack_peek((_stack_t*)stack, sizeof(STACK_DATA_T), (void *)element);
+    return STACK_GLUE(STACK_DATA_NAME, _stack_peek)(stack, element);
 }
 
+// Only the capacity check is inlined. Resizing the array is left to __stack_shrink()
 static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_pop)(__STACK_T *stack, STACK_DATA_T *element)
 {
-    return __stack_pop((_stack_t*)stack, sizeof(STACK_DATA_T), (void *)element);
+    if (!element || stack->number_of_items_in_table == 0) {
+        return true;
+    }
+    *element = stack->table[--(stack->number_of_items_in_table)];
+    if (stack->number_of_items_in_table < stack->shrink_threshold) {
+        return __stack_shrink((_stack_t*)stack, sizeof(STACK_DATA_T));
+    }
+    return false;
+}
+
+static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_pop_n)(__STACK_T *stack, STACK_DATA_T *elements, size_t n)
+{
+    return __stack_pop_n((_stack_t*)stack, sizeof(STACK_DATA_T), (void *)elements, n);
+}
+
+static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_peek_n)(__STACK_T *stack, STACK_DATA_T *elements, size_t n)
+{
+    return __stack_peek_n((_stack_t*)stack, sizeof(STACK_DATA_T), (void *)elements, n);
+}
+
+#ifdef STACK_TYPED
+static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_drop)(__STACK_T *stack)
+{
+    if (stack->number_of_items_in_table == 0) {
+        return true;
+    }
+    --(stack->number_of_items_in_table);
+    if (stack->number_of_items_in_table < stack->shrink_threshold) {
+        return __stack_shrink((_stack_t*)stack, sizeof(STACK_DATA_T));
+    }
+    return false;
 }
 
+static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_dup)(__STACK_T *stack)
+{
+    if (stack->number_of_items_in_table == 0) {
+        return true;
+    }
+    if (stack->number_of_items_in_table == stack->array_size &&
+        __stack_grow((_stack_t*)stack, sizeof(STACK_DATA_T), stack->number_of_items_in_table + 1)) {
+        return true;
+    }
+    stack->table[stack->number_of_items_in_table] = stack->table[stack->number_of_items_in_table - 1];
+    ++(stack->number_of_items_in_table);
+    return false;
+}
+
+static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_swap)(__STACK_T *stack)
+{
+    if (stack->number_of_items_in_table < 2) {
+        return true;
+    }
+    STACK_DATA_T *top = &(stack->table[stack->number_of_items_in_table - 1]);
+    STACK_DATA_T tmp_element = top[0];
+    top[0] = top[-1];
+    top[-1] = tmp_element;
+    return false;
+}
+
+// EX: if the stack contains 1,2,3<-top then after rotation, it will contain 2,3,1<-top
+static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_rot)(__STACK_T *stack)
+{
+    if (stack->number_of_items_in_table < 3) {
+        return true;
+    }
+    STACK_DATA_T *top = &(stack->table[stack->number_of_items_in_table - 1]);
+    STACK_DATA_T tmp_element = top[-2];
+    top[-2] = top[-1];
+    top[-1] = top[0];
+    top[0] = tmp_element;
+    return false;
+}
+#else
 static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_drop)(__STACK_T *stack)
 {
     return __stack_drop((_stack_t*)stack, sizeof(STACK_DATA_T));
@@ -142,10 +354,32 @@ static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_rot)(__STACK_T *stack)
 {
     return __stack_rot((_stack_t*)stack, sizeof(STACK_DATA_T));
 }
+#endif
 
+// Only the capacity check is inlined. Resizing the array is left to __stack_grow()
 static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_push)(__STACK_T *stack, STACK_DATA_T element)
 {
-    return __stack_push((_stack_t*)stack, sizeof(STACK_DATA_T), (void*)&element);
+    if (stack->number_of_items_in_table == stack->array_size &&
+        __stack_grow((_stack_t*)stack, sizeof(STACK_DATA_T), stack->number_of_items_in_table + 1)) {
+        return true;
+    }
+    stack->table[(stack->number_of_items_in_table)++] = element;
+    return false;
+}
+
+// Returns the (uninitialized) new top slot, NULL on memory allocation failure
+static inline STACK_DATA_T *STACK_GLUE(STACK_DATA_NAME, _stack_push_emplace)(__STACK_T *stack)
+{
+    if (stack->number_of_items_in_table == stack->array_size &&
+        __stack_grow((_stack_t*)stack, sizeof(STACK_DATA_T), stack->number_of_items_in_table + 1)) {
+        return NULL;
+    }
+    return &(stack->table[(stack->number_of_items_in_table)++]);
+}
+
+static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_push_n)(__STACK_T *stack, const STACK_DATA_T *elements, size_t n)
+{
+    return __stack_push_n((_stack_t*)stack, sizeof(STACK_DATA_T), (const void *)elements, n);
 }
 
 static inline size_t STACK_GLUE(STACK_DATA_NAME, _stack_get_num_elements)(__STACK_T *stack)
@@ -153,9 +387,27 @@ static inline size_t STACK_GLUE(STACK_DATA_NAME, _stack_get_num_elements)(__STAC
     return __stack_get_num_elements((_stack_t*)stack);
 }
 
+static inline size_t STACK_GLUE(STACK_DATA_NAME, _stack_get_num_resizes)(__STACK_T *stack)
+{
+    return __stack_get_num_resizes((_stack_t*)stack);
+}
+
+static inline stack_mark_t STACK_GLUE(STACK_DATA_NAME, _stack_mark)(__STACK_T *stack)
+{
+    return stack->number_of_items_in_table;
+}
+
+static inline bool STACK_GLUE(STACK_DATA_NAME, _stack_release)(__STACK_T *stack, stack_mark_t mark)
+{
+    return __stack_release((_stack_t*)stack, sizeof(STACK_DATA_T), mark);
+}
+
 #undef STACK_DATA_T
 #undef STACK_DATA_NAME
+#undef STACK_INLINE_CAP
+#undef STACK_TYPED
 #undef __STACK_T
+#undef __ISTACK_T
 
 #endif
 
@@ -0,0 +1,357 @@
+/**
+ * Work-stealing deque (Chase-Lev) in c
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-18: Initial creation
+ * 2026-10-19: Copy elements with relaxed atomic word loads/stores, and
+ *             only write the pop()'d element once the last one is won
+ *
+ * USAGE: see ws-deque.h
+ *
+ * Based on "Correct and Efficient Work-Stealing for Weak Memory Models"
+ * (Le, Pop, Cohen, Zappa Nardelli), which adapts the Chase-Lev deque
+ * to C11 atomics.
+ */
+
+#include <stdlib.h>
+#include <string.h> // memcpy()
+
+#define __WSDEQUE_WSDEQUE_C
+#include "ws-deque.h"
+#undef __WSDEQUE_WSDEQUE_C
+
+// Helper functions
+static inline _Atomic uintptr_t *_ws_deque_slot(ws_deque_array_t *array, size_t element_size, int64_t index);
+static void _ws_deque_load(ws_deque_array_t *array, size_t element_size, int64_t index, void *element);
+static void _ws_deque_store(ws_deque_array_t *array, size_t element_size, int64_t index, const void *element);
+static ws_deque_array_t *_ws_deque_alloc_array(size_t element_size, int64_t size);
+static ws_deque_array_t *_ws_deque_grow(ws_deque_t *deque, size_t element_size, ws_deque_array_t *array, int64_t top, int64_t bottom);
+
+
+/**
+ * Heap-allocate a new work-stealing deque
+ *
+ * @param **deque Pointer to the deque
+ * @param element_size [internal use] Size of element stored in deque
+ * @param initial_size Number of elements to store initially (rounded up
+ *                     to a power of 2 of at least WSDEQUE_MIN_SIZE)
+ * @return false on success, true on failure (memory allocation failure)
+ */
+bool __ws_deque_init(ws_deque_t **deque, size_t element_size, size_t initial_size)
+{
+    int64_t size = WSDEQUE_MIN_SIZE;
+    while ((size_t)size < initial_size) {
+        size *= 2;
+    }
+
+    *deque = aligned_alloc(WSDEQUE_CACHE_LINE, sizeof(**deque));
+    if (!*deque) {
+        return true;
+    }
+    ws_deque_array_t *array = _ws_deque_alloc_array(element_size, size);
+    if (!array) {
+        free(*deque);
+        *deque = NULL;
+        return true;
+    }
+    atomic_init(&((*deque)->top), 0);
+    atomic_init(&((*deque)->bottom), 0);
+    atomic_init(&((*deque)->array), array);
+    return false;
+}
+
+
+/**
+ * Free a work-stealing deque, including all of its retired arrays
+ * @note Must not be called while other threads use the deque
+ * @note The *deque is set to NULL
+ *
+ * @param **deque The deque to free
+ */
+void __ws_deque_destroy(ws_deque_t **deque)
+{
+    if (!deque || !*deque) {
+        return;
+    }
+    ws_deque_array_t *array = atomic_load(&((*deque)->array));
+    while (array) {
+        ws_deque_array_t *retired = array->retired;
+        free(array);
+        array = retired;
+    }
+    free(*deque);
+    *deque = NULL;
+}
+
+
+/**
+ * Push an item onto the bottom of the deque
+ * @note Owner thread only
+ *
+ * @param *deque The deque to push the item onto
+ * @param element_size [internal use] The size of an element stored in the deque
+ * @param *element The data to push onto the deque
+ * @return false on success, true on failure (memory allocation failure)
+ */
+bool __ws_deque_push(ws_deque_t *deque, size_t element_size, const void *element)
+{
+    int64_t bottom = atomic_load_explicit(&(deque->bottom), memory_order_relaxed);
+    int64_t top = atomic_load_explicit(&(deque->top), memory_order_acquire);
+    ws_deque_array_t *array = atomic_load_explicit(&(deque->array), memory_order_relaxed);
+
+    if (bottom - top > array->mask) {
+        array = _ws_deque_grow(deque, element_size, array, top, bottom);
+        if (!array) {
+            return true;
+        }
+    }
+    _ws_deque_store(array, element_size, bottom, element);
+
+    // Publish the element along with the new bottom
+    atomic_store_explicit(&(deque->bottom), bottom + 1, memory_order_release);
+    return false;
+}
+
+
+/**
+ * Remove the item on the bottom of the deque (the most recently pushed item)
+ * @note Owner thread only
+ *
+ * @param *deque The deque to remove the item from
+ * @param element_size [internal use] The size of an element stored in the deque
+ * @param *element A pointer to the location to store the pop'd value
+ * @return false on success, true on empty deque (or if a thief took
+ *         the last item) or null *element pointer
+ */
+bool __ws_deque_pop(ws_deque_t *deque, size_t element_size, void *element)
+{
+    if (!element) {
+        return true;
+    }
+
+    int64_t bottom = atomic_load_explicit(&(deque->bottom), memory_order_relaxed) - 1;
+    ws_deque_array_t *array = atomic_load_explicit(&(deque->array), memory_order_relaxed);
+
+    // Claim the bottom slot before looking at top, so that a thief either
+    // sees the claim or is seen by this thread
+    atomic_store_explicit(&(deque->bottom), bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t top = atomic_load_explicit(&(deque->top), memory_order_relaxed);
+
+    if (top > bottom) {
+        // Empty
+        atomic_store_explicit(&(deque->bottom), bottom + 1, memory_order_relaxed);
+        return true;
+    }
+
+    if (top < bottom) {
+        // More than one item left, so no thief can reach this one
+        _ws_deque_load(array, element_size, bottom, element);
+        return false;
+    }
+
+    // Last item: race the thieves for it. The caller's element is only
+    // written if this thread wins
+    char tmp_element[element_size];
+    _ws_deque_load(array, element_size, bottom, tmp_element);
+    bool lost = !atomic_compare_exchange_strong_explicit(&(deque->top), &top, top + 1,
+                                                         memory_order_seq_cst, memory_order_relaxed);
+    atomic_store_explicit(&(deque->bottom), bottom + 1, memory_order_relaxed);
+    if (!lost) {
+        memcpy(element, tmp_element, element_size);
+    }
+    return lost;
+}
+
+
+/**
+ * Remove the item on the top of the deque (the least recently pushed item).
+ * Retries when racing other thieves, so this only fails if the deque is
+ * empty.
+ * @note Any thread
+ *
+ * @param *deque The deque to steal the item from
+ * @param element_size [internal use] The size of an element stored in the deque
+ * @param *element A pointer to the location to store the stolen value
+ * @return false on success, true on empty deque or null *element pointer
+ */
+bool __ws_deque_steal(ws_deque_t *deque, size_t element_size, void *element)
+{
+    if (!element) {
+        return true;
+    }
+
+    char tmp_element[element_size];
+    while (true) {
+        int64_t top = atomic_load_explicit(&(deque->top), memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        int64_t bottom = atomic_load_explicit(&(deque->bottom), memory_order_acquire);
+
+        if (top >= bottom) {
+            return true;
+        }
+
+        // The slot may be overwritten once top moves on, in which case the
+        // compare-and-swap below fails and the copy is thrown away
+        ws_deque_array_t *array = atomic_load_explicit(&(deque->array), memory_order_acquire);
+        _ws_deque_load(array, element_size, top, tmp_element);
+
+        if (atomic_compare_exchange_strong_explicit(&(deque->top), &top, top + 1,
+                                                    memory_order_seq_cst, memory_order_relaxed)) {
+            memcpy(element, tmp_element, element_size);
+            return false;
+        }
+    }
+}
+
+
+/**
+ * Returns if there are any elements in the deque
+ * @note With other threads using the deque, the result may be
+ *       outdated by the time it is returned
+ *
+ * @param deque The deque to check if empty
+ * @return True if there are 0 elements in the deque,
+ *         False if not empty or if NULL deque
+ */
+bool __ws_deque_is_empty(ws_deque_t *deque)
+{
+    if (deque != NULL)
+    {
+        return __ws_deque_get_num_elements(deque) == 0;
+    }
+    return 0;
+}
+
+
+/**
+ * Returns the number of items in the deque
+ * @note With other threads using the deque, the result may be
+ *       outdated by the time it is returned
+ *
+ * @param deque The deque to retrieve the number of elements from
+ * @return The number of elements in the deque (0 if deque is NULL)
+ */
+size_t __ws_deque_get_num_elements(ws_deque_t *deque)
+{
+    if (deque != NULL)
+    {
+        int64_t top = atomic_load_explicit(&(deque->top), memory_order_relaxed);
+        int64_t bottom = atomic_load_explicit(&(deque->bottom), memory_order_relaxed);
+        return bottom > top ? (size_t)(bottom - top) : 0;
+    }
+    return 0;
+}
+
+
+/**
+ * Get the slot for an index
+ *
+ * @param array The array to index
+ * @param element_size [internal use] The size of an element stored in the deque
+ * @param index The (unwrapped) deque index
+ * @return A pointer to the first word of the slot
+ */
+static _Atomic uintptr_t *_ws_deque_slot(ws_deque_array_t *array, size_t element_size, int64_t index)
+{
+    return array->table + (WSDEQUE_WORDS(element_size) * (size_t)(index & array->mask));
+}
+
+
+/**
+ * Copy an element out of a slot, one word at a time. The owner may be
+ * storing to the slot at the same time, in which case the copy is a mix
+ * of both elements (and is thrown away by the caller).
+ *
+ * @param array The array to read
+ * @param element_size [internal use] The size of an element stored in the deque
+ * @param index The (unwrapped) deque index
+ * @param element Where to copy the element
+ */
+static void _ws_deque_load(ws_deque_array_t *array, size_t element_size, int64_t index, void *element)
+{
+    _Atomic uintptr_t *slot = _ws_deque_slot(array, element_size, index);
+    for (size_t offset = 0; offset < element_size; offset += sizeof(uintptr_t)) {
+        uintptr_t word = atomic_load_explicit(slot++, memory_order_relaxed);
+        size_t n = element_size - offset < sizeof(word) ? element_size - offset : sizeof(word);
+        memcpy((char *)element + offset, &word, n);
+    }
+}
+
+
+/**
+ * Copy an element into a slot, one word at a time
+ * @note Owner thread only
+ *
+ * @param array The array to write
+ * @param element_size [internal use] The size of an element stored in the deque
+ * @param index The (unwrapped) deque index
+ * @param element The element to copy
+ */
+static void _ws_deque_store(ws_deque_array_t *array, size_t element_size, int64_t index, const void *element)
+{
+    _Atomic uintptr_t *slot = _ws_deque_slot(array, element_size, index);
+    for (size_t offset = 0; offset < element_size; offset += sizeof(uintptr_t)) {
+        uintptr_t word = 0;
+        size_t n = element_size - offset < sizeof(word) ? element_size - offset : sizeof(word);
+        memcpy(&word, (const char *)element + offset, n);
+        atomic_store_explicit(slot++, word, memory_order_relaxed);
+    }
+}
+
+
+/**
+ * Allocate an array of slots
+ *
+ * @param element_size [internal use] The size of an element stored in the deque
+ * @param size The number of slots (a power of 2)
+ * @return The array, NULL on memory allocation failure
+ */
+static ws_deque_array_t *_ws_deque_alloc_array(size_t element_size, int64_t size)
+{
+    size_t slot_size = WSDEQUE_WORDS(element_size) * sizeof(uintptr_t);
+    if ((size_t)size > ((size_t)-1 - sizeof(ws_deque_array_t)) / slot_size) {
+        return NULL;
+    }
+    ws_deque_array_t *array = malloc(sizeof(*array) + slot_size * (size_t)size);
+    if (!array) {
+        return NULL;
+    }
+    array->retired = NULL;
+    array->mask = size - 1;
+    return array;
+}
+
+
+/**
+ * Replace the deque's array with one twice its size. The old array is
+ * kept (thieves may still be reading it) until the deque is destroyed.
+ * @note Owner thread only
+ *
+ * @param deque The deque to grow
+ * @param element_size [internal use] The size of an element stored in the deque
+ * @param array The deque's current array
+ * @param top The top index
+ * @param bottom The bottom index
+ * @return The new array, NULL on memory allocation failure
+ */
+static ws_deque_array_t *_ws_deque_grow(ws_deque_t *deque, size_t element_size, ws_deque_array_t *array, int64_t top, int64_t bottom)
+{
+    ws_deque_array_t *new_array = _ws_deque_alloc_array(element_size, (array->mask + 1) * 2);
+    if (!new_array) {
+        return NULL;
+    }
+    size_t words = WSDEQUE_WORDS(element_size);
+    for (int64_t i = top; i < bottom; i++) {
+        _Atomic uintptr_t *from = _ws_deque_slot(array, element_size, i);
+        _Atomic uintptr_t *to = _ws_deque_slot(new_array, element_size, i);
+        for (size_t w = 0; w < words; w++) {
+            atomic_store_explicit(&to[w], atomic_load_explicit(&from[w], memory_order_relaxed),
+                                  memory_order_relaxed);
+        }
+    }
+    new_array->retired = array;
+    atomic_store_explicit(&(deque->array), new_array, memory_order_release);
+    return new_array;
+}
@@ -0,0 +1,136 @@
+/**
+ * Work-stealing deque (Chase-Lev) in c
+ * (C) Ray Clemens 2026
+ *
+ * Updates:
+ * 2026-10-18: Initial creation
+ * 2026-10-19: Store elements in atomic words (thieves may read a slot
+ *             while the owner overwrites it)
+ *
+ * USAGE:
+ * Define WSDEQUE_DATA_T as the data type to be stored in the deque structure.
+ * Define WSDEQUE_DATA_NAME as the data name for the associated function calls.
+ * **NOTE**: Do not enclose the above macros in parens! For example, if the
+ *           data type is char* , define the macros as char* , not (char*)
+ * **NOTE**: Like the Stack data structure, elements are stored by value.
+ * **NOTE**: A slot may be read by a thief while the owner overwrites it
+ *           (the thief's compare-and-swap then fails and the copy is
+ *           thrown away). To keep this well-defined, elements are copied
+ *           in and out of the slots one machine word (uintptr_t) at a
+ *           time with relaxed atomics. Element types must therefore be
+ *           plain data that can be copied byte by byte, and each slot
+ *           takes sizeof(WSDEQUE_DATA_T) rounded up to a whole number of
+ *           words. Elements of at most one word (pointers, indices) are
+ *           moved with a single atomic load or store.
+ *
+ * Each deque has a single owner thread, which uses push() and pop() on the
+ * bottom end like a stack (LIFO). Any number of other threads may steal()
+ * from the top end (FIFO). push() and pop() are wait-free (apart from
+ * growing the array), while steal() and a pop() of the very last element
+ * resolve races with a compare-and-swap on the top index.
+ *
+ * The array doubles in size when the owner pushes onto a full deque. Since
+ * thieves may still be reading the old array, old arrays are only free()'d
+ * by destroy(). The memory held is at most twice the largest array.
+ * **NOTE**: Requires C11 atomics (<stdatomic.h>)
+ */
+
+#include <stddef.h> // size_t
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#ifndef WSDEQUE_H
+#define WSDEQUE_H
+
+#define WSDEQUE_CACHE_LINE 64
+#define WSDEQUE_MIN_SIZE 16
+
+// Number of words in a slot
+#define WSDEQUE_WORDS(element_size) (((element_size) + sizeof(uintptr_t) - 1) / sizeof(uintptr_t))
+
+#define _WSDEQUE_GLUE(x, y) x##y
+#define WSDEQUE_GLUE(x, y) _WSDEQUE_GLUE(x, y)
+
+typedef struct ws_deque_array_t {
+    struct ws_deque_array_t *retired;      // The array this one replaced (kept until destroy)
+    int64_t mask;                          // Number of slots - 1 (the number of slots is a power of 2)
+    _Atomic uintptr_t table[];             // The slots (WSDEQUE_WORDS(element_size) words each)
+} ws_deque_array_t;
+
+typedef struct ws_deque_t {
+    _Alignas(WSDEQUE_CACHE_LINE) _Atomic int64_t top;      // Next index to steal (advanced by thieves)
+    _Alignas(WSDEQUE_CACHE_LINE) _Atomic int64_t bottom;   // Next index to push (owned by the owner)
+    _Atomic(ws_deque_array_t *) array;                      // Current array
+} ws_deque_t;
+
+bool __ws_deque_init(ws_deque_t **deque, size_t element_size, size_t initial_size);
+void __ws_deque_destroy(ws_deque_t **deque);
+bool __ws_deque_push(ws_deque_t *deque, size_t element_size, const void *element);
+bool __ws_deque_pop(ws_deque_t *deque, size_t element_size, void *element);
+bool __ws_deque_steal(ws_deque_t *deque, size_t element_size, void *element);
+bool __ws_deque_is_empty(ws_deque_t *deque);
+size_t __ws_deque_get_num_elements(ws_deque_t *deque);
+
+#endif
+
+// Now on to the "type generic weirdness"
+#ifndef __WSDEQUE_WSDEQUE_C
+
+#if !defined(WSDEQUE_DATA_NAME) || !defined(WSDEQUE_DATA_T)
+# error "Must define both WSDEQUE_DATA_NAME and WSDEQUE_DATA_T before including ws-deque.h"
+#endif
+
+#define __WSDEQUE_T WSDEQUE_GLUE(WSDEQUE_DATA_NAME, _ws_deque_t)
+
+// Wrapping the untyped deque gives each generic type its own struct so
+// that mixing deques of different types is caught at compile time
+typedef struct __WSDEQUE_T {
+    ws_deque_t deque;
+} __WSDEQUE_T;
+
+// Function prototypes
+static inline bool WSDEQUE_GLUE(WSDEQUE_DATA_NAME, _ws_deque_init)(__WSDEQUE_T **deque, size_t initial_size)
+{
+    return __ws_deque_init((ws_deque_t**)deque, sizeof(WSDEQUE_DATA_T), initial_size);
+}
+
+static inline void WSDEQUE_GLUE(WSDEQUE_DATA_NAME, _ws_deque_destroy)(__WSDEQUE_T **deque)
+{
+    __ws_deque_destroy((ws_deque_t**)deque);
+}
+
+// Owner only
+static inline bool WSDEQUE_GLUE(WSDEQUE_DATA_NAME, _ws_deque_push)(__WSDEQUE_T *deque, WSDEQUE_DATA_T element)
+{
+    return __ws_deque_push((ws_deque_t*)deque, sizeof(WSDEQUE_DATA_T), (const void *)&element);
+}
+
+// Owner only
+static inline bool WSDEQUE_GLUE(WSDEQUE_DATA_NAME, _ws_deque_pop)(__WSDEQUE_T *deque, WSDEQUE_DATA_T *element)
+{
+    return __ws_deque_pop((ws_deque_t*)deque, sizeof(WSDEQUE_DATA_T), (void *)element);
+}
+
+// Any thread
+static inline bool WSDEQUE_GLUE(WSDEQUE_DATA_NAME, _ws_deque_steal)(__WSDEQUE_T *deque, WSDEQUE_DATA_T *element)
+{
+    return __ws_deque_steal((ws_deque_t*)deque, sizeof(WSDEQUE_DATA_T), (void *)element);
+}
+
+static inline bool WSDEQUE_GLUE(WSDEQUE_DATA_NAME, _ws_deque_is_empty)(__WSDEQUE_T *deque)
+{
+    return __ws_deque_is_empty((ws_deque_t*)deque);
+}
+
+static inline size_t WSDEQUE_GLUE(WSDEQUE_DATA_NAME, _ws_deque_get_num_elements)(__WSDEQUE_T *deque)
+{
+    return __ws_deque_get_num_elements((ws_deque_t*)deque);
+}
+
+#undef WSDEQUE_DATA_T
+#undef WSDEQUE_DATA_NAME
+#undef __WSDEQUE_T
+
+#endif
+